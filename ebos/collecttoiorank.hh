@@ -264,6 +264,9 @@ public:
             indexMaps_.clear();
             indexMaps_.resize(comm.size());
 
+            // the cached keys of the block data of each rank
+            receivedBlockKeys_.resize(comm.size());
+
             // distribute global id's to io rank for later association of dof's
             DistributeIndexMapping distIndexMapping(globalCartesianIndex_,
                                                     distributedCartesianIndex,
@@ -305,11 +308,15 @@ public:
                     assert(ret.second);
                 }
 
-                MessageBufferType buffer;
-                pack(0, buffer);
-
-                // the last index map is the local one
-                doUnpack(indexMaps.back(), buffer);
+                // the data of the I/O rank itself is directly copied into the global
+                // arrays. the last index map is the local one.
+                const IndexMapType& indexMap = indexMaps.back();
+                for (const auto& pair : localCellData_) {
+                    const auto& localData = pair.second.data;
+                    auto& globalData = globalCellData_.data(pair.first);
+                    for (size_t i = 0; i < indexMap.size(); ++i)
+                        globalData[indexMap[i]] = localData[localIndexMap_[i]];
+                }
             }
         }
 
@@ -421,26 +428,36 @@ public:
 
     };
 
+    typedef std::vector<std::pair<std::string, int> > BlockKeyVector;
+
+    /*!
+     * \brief Packs the block data as a flat array of values.
+     *
+     * The keys of the block data usually do not change between report steps, so they
+     * are only sent if they differ from the ones sent for the previous report step.
+     * The receiving side caches the keys of each link.
+     */
     class PackUnPackBlockData : public P2PCommunicatorType::DataHandleInterface
     {
         const std::map<std::pair<std::string, int>, double>& localBlockData_;
         std::map<std::pair<std::string, int>, double>& globalBlockValues_;
+        BlockKeyVector& sentBlockKeys_;
+        std::vector<BlockKeyVector>& receivedBlockKeys_;
 
     public:
         PackUnPackBlockData(const std::map<std::pair<std::string, int>, double>& localBlockData,
                             std::map<std::pair<std::string, int>, double>& globalBlockValues,
+                            BlockKeyVector& sentBlockKeys,
+                            std::vector<BlockKeyVector>& receivedBlockKeys,
                             bool isIORank)
             : localBlockData_(localBlockData)
             , globalBlockValues_(globalBlockValues)
+            , sentBlockKeys_(sentBlockKeys)
+            , receivedBlockKeys_(receivedBlockKeys)
         {
-            if (isIORank) {
-                MessageBufferType buffer;
-                pack(0, buffer);
-
-                // pass a dummyLink to satisfy virtual class
-                int dummyLink = -1;
-                unpack(dummyLink, buffer);
-            }
+            if (isIORank)
+                // the data of the I/O rank itself does not need to be packed
+                globalBlockValues_.insert(localBlockData_.begin(), localBlockData_.end());
         }
 
         // pack all data associated with link
@@ -450,33 +467,86 @@ public:
             if (link != 0)
                 throw std::logic_error("link in method pack is not 0 as expected");
 
-            // write all block data
-            unsigned int size = localBlockData_.size();
-            buffer.write(size);
-            for (const auto& map : localBlockData_) {
-                buffer.write(map.first.first);
-                buffer.write(map.first.second);
-                buffer.write(map.second);
+            // check whether the keys have changed since the last time
+            bool keysChanged = (sentBlockKeys_.size() != localBlockData_.size());
+            if (!keysChanged) {
+                auto sentKeyIt = sentBlockKeys_.begin();
+                for (const auto& pair : localBlockData_) {
+                    if (pair.first != *sentKeyIt) {
+                        keysChanged = true;
+                        break;
+                    }
+                    ++ sentKeyIt;
+                }
             }
+
+            int keysChangedInt = keysChanged?1:0;
+            buffer.write(keysChangedInt);
+            if (keysChanged) {
+                sentBlockKeys_.clear();
+                unsigned int size = localBlockData_.size();
+                buffer.write(size);
+                for (const auto& pair : localBlockData_) {
+                    sentBlockKeys_.push_back(pair.first);
+                    buffer.write(pair.first.first);
+                    buffer.write(pair.first.second);
+                }
+            }
+
+            // write the values in the order of the keys
+            for (const auto& pair : localBlockData_)
+                buffer.write(pair.second);
         }
 
         // unpack all data associated with link
-        void unpack(int /*link*/, MessageBufferType& buffer)
+        void unpack(int link, MessageBufferType& buffer)
         {
-            // read all block data
-            unsigned int size = 0;
-            buffer.read(size);
-            for (size_t i = 0; i < size; ++i) {
-                std::string name;
-                int idx;
-                double data;
-                buffer.read(name);
-                buffer.read(idx);
-                buffer.read(data);
-                globalBlockValues_[std::make_pair(name, idx)] = data;
+            BlockKeyVector& keys = receivedBlockKeys_[link];
+
+            int keysChangedInt = 0;
+            buffer.read(keysChangedInt);
+            if (keysChangedInt) {
+                unsigned int size = 0;
+                buffer.read(size);
+                keys.resize(size);
+                for (auto& key : keys) {
+                    buffer.read(key.first);
+                    buffer.read(key.second);
+                }
             }
+
+            for (const auto& key : keys) {
+                double value;
+                buffer.read(value);
+                globalBlockValues_[key] = value;
+            }
+        }
+
+    };
+
+    /*!
+     * \brief Combines several data handles so that their data is transferred using a
+     *        single exchange.
+     */
+    class PackUnPackCombined : public P2PCommunicatorType::DataHandleInterface
+    {
+        std::vector<typename P2PCommunicatorType::DataHandleInterface*> handles_;
+
+    public:
+        void addHandle(typename P2PCommunicatorType::DataHandleInterface& handle)
+        { handles_.push_back(&handle); }
+
+        void pack(int link, MessageBufferType& buffer)
+        {
+            for (auto* handle : handles_)
+                handle->pack(link, buffer);
         }
 
+        void unpack(int link, MessageBufferType& buffer)
+        {
+            for (auto* handle : handles_)
+                handle->unpack(link, buffer);
+        }
     };
 
     // gather solution to rank 0 for EclipseWriter
@@ -513,11 +583,16 @@ public:
         PackUnPackBlockData
             packUnpackBlockData(localBlockData,
                                 globalBlockData_,
+                                sentBlockKeys_,
+                                receivedBlockKeys_,
                                 isIORank());
 
-        toIORankComm_.exchange(packUnpackCellData);
-        toIORankComm_.exchange(packUnpackWellData);
-        toIORankComm_.exchange(packUnpackBlockData);
+        // send everything using a single exchange
+        PackUnPackCombined packUnpackCombined;
+        packUnpackCombined.addHandle(packUnpackCellData);
+        packUnpackCombined.addHandle(packUnpackWellData);
+        packUnpackCombined.addHandle(packUnpackBlockData);
+        toIORankComm_.exchange(packUnpackCombined);
 
 
 
@@ -585,6 +660,8 @@ protected:
     std::vector<int> globalRanks_;
     Opm::data::Solution globalCellData_;
     std::map<std::pair<std::string, int>, double> globalBlockData_;
+    BlockKeyVector sentBlockKeys_;
+    std::vector<BlockKeyVector> receivedBlockKeys_;
     Opm::data::Wells globalWellData_;
 };
 
@@ -24,22 +24,104 @@
  * \file
  *
  * \brief A general-purpose simulator for ECL decks using the black-oil model.
+ *
+ * The simulator is compiled for several combinations of fluid phases and extensions of
+ * the black-oil model. At startup, the deck is examined and the most specialized variant
+ * which is able to simulate it is used.
  */
 #include "config.h"
 
-#include <opm/material/common/quad.hpp>
-#include <ewoms/common/start.hh>
-
-#include "eclproblem.hh"
+#include "ebos.hh"
 
-BEGIN_PROPERTIES
+#include <dune/common/parallel/mpihelper.hh>
 
-NEW_TYPE_TAG(EclProblem, INHERITS_FROM(BlackOilModel, EclBaseProblem));
-
-END_PROPERTIES
+#include <iostream>
+#include <memory>
+#include <string>
 
 int main(int argc, char **argv)
 {
-    typedef TTAG(EclProblem) ProblemTypeTag;
-    return Ewoms::start<ProblemTypeTag>(argc, argv);
+    typedef TTAG(EbosTypeTag) BaseTypeTag;
+    typedef GET_PROP_TYPE(BaseTypeTag, Vanguard) Vanguard;
+
+    std::unique_ptr<Opm::Deck> deck;
+    std::unique_ptr<Opm::EclipseState> eclState;
+    std::unique_ptr<Opm::Schedule> schedule;
+    std::unique_ptr<Opm::SummaryConfig> summaryConfig;
+
+    // the deck file name is determined using the parameter system of the default
+    // variant. since the parameters must be registered again by the selected variant of
+    // the simulator, they are reset afterwards. if no deck was specified, the default
+    // variant takes care of printing the help message. (MPI must be initialized for
+    // this, the variants later re-use the MPI helper object.)
+    Dune::MPIHelper::instance(argc, argv);
+    std::string deckFileName;
+    {
+        int paramStatus = Ewoms::setupParameters_<BaseTypeTag>(argc, const_cast<const char**>(argv));
+        if (paramStatus == 1)
+            return 1;
+        if (paramStatus == 2)
+            return 0;
+
+        deckFileName = EWOMS_GET_PARAM(BaseTypeTag, std::string, EclDeckFileName);
+        Ewoms::Parameters::reset<BaseTypeTag>();
+    }
+    if (deckFileName.empty())
+        return Ewoms::ebosBlackOilMain(argc, argv, nullptr, nullptr, nullptr, nullptr);
+
+    // the deck is examined before the selected variant of the simulator is started. if
+    // the deck cannot be read at this point, the default variant takes care of
+    // reporting the error.
+    try {
+        Opm::resetLocale();
+
+        deckFileName = Vanguard::canonicalDeckPath(deckFileName).string();
+        Vanguard::readDeck(deckFileName, deck, eclState, schedule, summaryConfig);
+    }
+    catch (...) {
+        return Ewoms::ebosBlackOilMain(argc, argv, nullptr, nullptr, nullptr, nullptr);
+    }
+
+    bool waterActive = deck->hasKeyword("WATER");
+    bool oilActive = deck->hasKeyword("OIL");
+    bool gasActive = deck->hasKeyword("GAS");
+    bool enableSolvent = deck->hasKeyword("SOLVENT");
+    bool enablePolymer = deck->hasKeyword("POLYMER");
+    bool enableEnergy = deck->hasKeyword("THERMAL");
+    int numExtensions = enableSolvent + enablePolymer + enableEnergy;
+
+    auto* deckPtr = deck.get();
+    auto* eclStatePtr = eclState.get();
+    auto* schedulePtr = schedule.get();
+    auto* summaryConfigPtr = summaryConfig.get();
+
+    // two-phase variants. if a two-phase deck requires an extension for which no
+    // two-phase variant is available, the corresponding three-phase variant is used.
+    if (oilActive && waterActive && !gasActive) {
+        if (numExtensions == 0)
+            return Ewoms::ebosOilWaterMain(argc, argv, deckPtr, eclStatePtr, schedulePtr, summaryConfigPtr);
+        else if (numExtensions == 1 && enablePolymer)
+            return Ewoms::ebosOilWaterPolymerMain(argc, argv, deckPtr, eclStatePtr, schedulePtr, summaryConfigPtr);
+    }
+    else if (oilActive && gasActive && !waterActive) {
+        if (numExtensions == 0)
+            return Ewoms::ebosGasOilMain(argc, argv, deckPtr, eclStatePtr, schedulePtr, summaryConfigPtr);
+    }
+
+    // three-phase variants
+    if (numExtensions == 0)
+        return Ewoms::ebosBlackOilMain(argc, argv, deckPtr, eclStatePtr, schedulePtr, summaryConfigPtr);
+    else if (numExtensions == 1 && enableSolvent)
+        return Ewoms::ebosSolventMain(argc, argv, deckPtr, eclStatePtr, schedulePtr, summaryConfigPtr);
+    else if (numExtensions == 1 && enablePolymer)
+        return Ewoms::ebosPolymerMain(argc, argv, deckPtr, eclStatePtr, schedulePtr, summaryConfigPtr);
+    else if (numExtensions == 1 && enableEnergy)
+        return Ewoms::ebosThermalMain(argc, argv, deckPtr, eclStatePtr, schedulePtr, summaryConfigPtr);
+
+    std::cerr << "No variant of the simulator which supports the combination of "
+              << (enableSolvent ? "SOLVENT " : "")
+              << (enablePolymer ? "POLYMER " : "")
+              << (enableEnergy ? "THERMAL " : "")
+              << "has been compiled.\n";
+    return 1;
 }
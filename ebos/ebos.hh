@@ -0,0 +1,120 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief The type tag of the ECL black-oil simulator and the entry points of its
+ *        compile-time specialized variants.
+ */
+#ifndef EWOMS_EBOS_HH
+#define EWOMS_EBOS_HH
+
+#include <ewoms/common/start.hh>
+
+#include "eclproblem.hh"
+
+BEGIN_PROPERTIES
+
+NEW_TYPE_TAG(EbosTypeTag, INHERITS_FROM(BlackOilModel, EclBaseProblem));
+
+END_PROPERTIES
+
+namespace Ewoms {
+
+/*!
+ * \ingroup EclBlackOilSimulator
+ *
+ * \brief Run the simulator for a given type tag.
+ *
+ * If a deck is specified, it is used instead of parsing the deck file again.
+ */
+template <class TypeTag>
+int ebosVariantMain(int argc, char **argv,
+                    Opm::Deck* deck,
+                    Opm::EclipseState* eclState,
+                    Opm::Schedule* schedule,
+                    Opm::SummaryConfig* summaryConfig)
+{
+    typedef typename GET_PROP_TYPE(TypeTag, Vanguard) Vanguard;
+
+    if (deck)
+        Vanguard::setExternalDeck(deck, eclState, schedule, summaryConfig);
+
+    return Ewoms::start<TypeTag>(argc, argv);
+}
+
+// the entry points of the variants of the simulator. each of them is instantiated in a
+// separate compile unit.
+
+//! Three-phase black-oil without any extensions
+int ebosBlackOilMain(int argc, char **argv,
+                     Opm::Deck* deck,
+                     Opm::EclipseState* eclState,
+                     Opm::Schedule* schedule,
+                     Opm::SummaryConfig* summaryConfig);
+
+//! Two-phase oil-water
+int ebosOilWaterMain(int argc, char **argv,
+                     Opm::Deck* deck,
+                     Opm::EclipseState* eclState,
+                     Opm::Schedule* schedule,
+                     Opm::SummaryConfig* summaryConfig);
+
+//! Two-phase gas-oil
+int ebosGasOilMain(int argc, char **argv,
+                   Opm::Deck* deck,
+                   Opm::EclipseState* eclState,
+                   Opm::Schedule* schedule,
+                   Opm::SummaryConfig* summaryConfig);
+
+//! Two-phase oil-water with polymers
+int ebosOilWaterPolymerMain(int argc, char **argv,
+                            Opm::Deck* deck,
+                            Opm::EclipseState* eclState,
+                            Opm::Schedule* schedule,
+                            Opm::SummaryConfig* summaryConfig);
+
+//! Three-phase black-oil with solvents
+int ebosSolventMain(int argc, char **argv,
+                    Opm::Deck* deck,
+                    Opm::EclipseState* eclState,
+                    Opm::Schedule* schedule,
+                    Opm::SummaryConfig* summaryConfig);
+
+//! Three-phase black-oil with polymers
+int ebosPolymerMain(int argc, char **argv,
+                    Opm::Deck* deck,
+                    Opm::EclipseState* eclState,
+                    Opm::Schedule* schedule,
+                    Opm::SummaryConfig* summaryConfig);
+
+//! Three-phase black-oil with energy conservation
+int ebosThermalMain(int argc, char **argv,
+                    Opm::Deck* deck,
+                    Opm::EclipseState* eclState,
+                    Opm::Schedule* schedule,
+                    Opm::SummaryConfig* summaryConfig);
+
+} // namespace Ewoms
+
+#endif
@@ -47,6 +47,8 @@
 #include <vector>
 #include <unordered_set>
 #include <array>
+#include <memory>
+#include <string>
 
 namespace Ewoms {
 template <class TypeTag>
@@ -135,6 +137,41 @@ public:
         throw std::invalid_argument("Cannot find input case "+caseName);
     }
 
+    /*!
+     * \brief Parse an ECL deck and create the objects which are derived from it.
+     *
+     * This is used by the constructor if no external deck was specified. It can also be
+     * called before any simulator is instantiated, e.g., to examine the deck in order to
+     * decide which simulator ought to be used.
+     */
+    static void readDeck(const std::string& fileName,
+                         std::unique_ptr<Opm::Deck>& deck,
+                         std::unique_ptr<Opm::EclipseState>& eclState,
+                         std::unique_ptr<Opm::Schedule>& schedule,
+                         std::unique_ptr<Opm::SummaryConfig>& summaryConfig)
+    {
+        Opm::Parser parser;
+        typedef std::pair<std::string, Opm::InputError::Action> ParseModePair;
+        typedef std::vector<ParseModePair> ParseModePairs;
+
+        ParseModePairs tmp;
+        tmp.emplace_back(Opm::ParseContext::PARSE_RANDOM_SLASH, Opm::InputError::IGNORE);
+        tmp.emplace_back(Opm::ParseContext::PARSE_MISSING_DIMS_KEYWORD, Opm::InputError::WARN);
+        tmp.emplace_back(Opm::ParseContext::SUMMARY_UNKNOWN_WELL, Opm::InputError::WARN);
+        tmp.emplace_back(Opm::ParseContext::SUMMARY_UNKNOWN_GROUP, Opm::InputError::WARN);
+        Opm::ParseContext parseContext(tmp);
+
+        deck.reset(new Opm::Deck(parser.parseFile(fileName , parseContext)));
+        eclState.reset(new Opm::EclipseState(*deck, parseContext));
+        {
+            const auto& grid = eclState->getInputGrid();
+            const Opm::TableManager table ( *deck );
+            const Opm::Eclipse3DProperties eclipseProperties (*deck  , table, grid);
+            schedule.reset(new Opm::Schedule(*deck, grid, eclipseProperties, Opm::Phases(true, true, true), parseContext ));
+            summaryConfig.reset(new Opm::SummaryConfig(*deck, *schedule, table,  parseContext));
+        }
+    }
+
     /*!
      * \brief Set the Opm::EclipseState and the Opm::Deck object which ought to be used
      *        when the simulator vanguard is instantiated.
@@ -201,27 +238,11 @@ public:
             if (myRank == 0)
                 std::cout << "Reading the deck file '" << fileName << "'" << std::endl;
 
-            Opm::Parser parser;
-            typedef std::pair<std::string, Opm::InputError::Action> ParseModePair;
-            typedef std::vector<ParseModePair> ParseModePairs;
-
-            ParseModePairs tmp;
-            tmp.emplace_back(Opm::ParseContext::PARSE_RANDOM_SLASH, Opm::InputError::IGNORE);
-            tmp.emplace_back(Opm::ParseContext::PARSE_MISSING_DIMS_KEYWORD, Opm::InputError::WARN);
-            tmp.emplace_back(Opm::ParseContext::SUMMARY_UNKNOWN_WELL, Opm::InputError::WARN);
-            tmp.emplace_back(Opm::ParseContext::SUMMARY_UNKNOWN_GROUP, Opm::InputError::WARN);
-            Opm::ParseContext parseContext(tmp);
-
-            internalDeck_.reset(new Opm::Deck(parser.parseFile(fileName , parseContext)));
-            internalEclState_.reset(new Opm::EclipseState(*internalDeck_, parseContext));
-            {
-                const auto& grid = internalEclState_->getInputGrid();
-                const Opm::TableManager table ( *internalDeck_ );
-                const Opm::Eclipse3DProperties eclipseProperties (*internalDeck_  , table, grid);
-                internalSchedule_.reset(new Opm::Schedule(*internalDeck_, grid, eclipseProperties, Opm::Phases(true, true, true), parseContext ));
-                internalSummaryConfig_.reset(new Opm::SummaryConfig(*internalDeck_, *internalSchedule_, table,  parseContext));
-            }
-
+            readDeck(fileName,
+                     internalDeck_,
+                     internalEclState_,
+                     internalSchedule_,
+                     internalSummaryConfig_);
 
             deck_ = &(*internalDeck_);
             eclState_ = &(*internalEclState_);
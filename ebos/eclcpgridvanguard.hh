@@ -31,6 +31,8 @@
 #include "ecltransmissibility.hh"
 #include "femcpgridcompat.hh"
 
+#include <ewoms/parallel/threadedentityiterator.hh>
+
 #include <opm/grid/CpGrid.hpp>
 #include <opm/grid/cpgrid/GridHelpers.hpp>
 
@@ -168,24 +170,31 @@ public:
 #else
             ElementMapper elemMapper(this->gridView());
 #endif
-            auto elemIt = gridView.template begin</*codim=*/0>();
-            const auto& elemEndIt = gridView.template end</*codim=*/0>();
-            for (; elemIt != elemEndIt; ++ elemIt) {
-                const auto& elem = *elemIt;
-                auto isIt = gridView.ibegin(elem);
-                const auto& isEndIt = gridView.iend(elem);
-                for (; isIt != isEndIt; ++ isIt) {
-                    const auto& is = *isIt;
-                    if (!is.neighbor())
-                        continue;
-
-                    unsigned I = elemMapper.index(is.inside());
-                    unsigned J = elemMapper.index(is.outside());
-
-                    // FIXME (?): this is not portable!
-                    unsigned faceIdx = is.id();
-
-                    faceTrans[faceIdx] = globalTrans_->transmissibility(I, J);
+            ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+            {
+                auto elemIt = threadedElemIt.beginParallel();
+                for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                    const auto& elem = *elemIt;
+                    auto isIt = gridView.ibegin(elem);
+                    const auto& isEndIt = gridView.iend(elem);
+                    for (; isIt != isEndIt; ++ isIt) {
+                        const auto& is = *isIt;
+                        if (!is.neighbor())
+                            continue;
+
+                        unsigned I = elemMapper.index(is.inside());
+                        unsigned J = elemMapper.index(is.outside());
+
+                        // FIXME (?): this is not portable!
+                        unsigned faceIdx = is.id();
+
+                        // both elements write the same value for a face
+                        if (I < J)
+                            faceTrans[faceIdx] = globalTrans_->transmissibility(I, J);
+                    }
                 }
             }
 
@@ -196,6 +205,12 @@ public:
             }
             grid_->switchToDistributedView();
 
+            // the transmissibilities of the global grid are only required to write the
+            // initial output files, which is exclusively done by the I/O rank. the other
+            // ranks do not need to keep them around.
+            if (mpiRank != 0)
+                releaseGlobalTransmissibilities();
+
             delete cartesianIndexMapper_;
             cartesianIndexMapper_ = nullptr;
         }
@@ -227,33 +227,22 @@ protected:
         exteriorDofIdx_ = scvf.exteriorIndex();
         assert(interiorDofIdx_ != exteriorDofIdx_);
 
-        unsigned I = stencil.globalSpaceIndex(interiorDofIdx_);
-        unsigned J = stencil.globalSpaceIndex(exteriorDofIdx_);
-
-        Scalar trans = problem.transmissibility(elemCtx, interiorDofIdx_, exteriorDofIdx_);
-        Scalar faceArea = scvf.area();
-        Scalar thpres = problem.thresholdPressure(I, J);
-
-        // estimate the gravity correction: for performance reasons we use a simplified
-        // approach for this flux module that assumes that gravity is constant and always
-        // acts into the downwards direction. (i.e., no centrifuge experiments, sorry.)
-        Scalar g = elemCtx.problem().gravity()[dimWorld - 1];
+        // all static quantities of the face are read from a single precomputed
+        // record. this includes the gravity correction: for performance reasons we use a
+        // simplified approach for this flux module that assumes that gravity is constant
+        // and always acts into the downwards direction. (i.e., no centrifuge
+        // experiments, sorry.) Also, the depth of a DOF is not the Z coordinate of its
+        // centroid, but it is provided by the problem because ECL seems to like to be
+        // inconsistent on that front...
+        const auto& faceData = problem.faceData(elemCtx, interiorDofIdx_, exteriorDofIdx_);
+        Scalar trans = faceData.transmissibility;
+        Scalar faceArea = faceData.faceArea;
+        Scalar thpres = faceData.thresholdPressure;
+        Scalar gravityDepthTerm = faceData.gravityDepthTerm;
 
         const auto& intQuantsIn = elemCtx.intensiveQuantities(interiorDofIdx_, timeIdx);
         const auto& intQuantsEx = elemCtx.intensiveQuantities(exteriorDofIdx_, timeIdx);
 
-        // this is quite hacky because the dune grid interface does not provide a
-        // cellCenterDepth() method (so we ask the problem to provide it). The "good"
-        // solution would be to take the Z coordinate of the element centroids, but since
-        // ECL seems to like to be inconsistent on that front, it needs to be done like
-        // here...
-        Scalar zIn = problem.dofCenterDepth(elemCtx, interiorDofIdx_, timeIdx);
-        Scalar zEx = problem.dofCenterDepth(elemCtx, exteriorDofIdx_, timeIdx);
-
-        // the distances from the DOF's depths. (i.e., the additional depth of the
-        // exterior DOF)
-        Scalar distZ = zIn - zEx;
-
         for (unsigned phaseIdx=0; phaseIdx < numPhases; phaseIdx++) {
             if (!FluidSystem::phaseIsActive(phaseIdx))
                 continue;
@@ -278,7 +267,7 @@ protected:
 
             const Evaluation& pressureInterior = intQuantsIn.fluidState().pressure(phaseIdx);
             Evaluation pressureExterior = Toolbox::value(intQuantsEx.fluidState().pressure(phaseIdx));
-            pressureExterior += rhoAvg*(distZ*g);
+            pressureExterior += rhoAvg*gravityDepthTerm;
 
             pressureDifference_[phaseIdx] = pressureExterior - pressureInterior;
 
@@ -294,32 +283,16 @@ protected:
                 upIdx_[phaseIdx] = interiorDofIdx_;
                 dnIdx_[phaseIdx] = exteriorDofIdx_;
             }
-            else {
+            else if (faceData.interiorUpstreamOnTie) {
                 // if the pressure difference is zero, we chose the DOF which has the
-                // larger volume associated to it as upstream DOF
-                Scalar Vin = elemCtx.dofVolume(interiorDofIdx_, /*timeIdx=*/0);
-                Scalar Vex = elemCtx.dofVolume(exteriorDofIdx_, /*timeIdx=*/0);
-                if (Vin > Vex) {
-                    upIdx_[phaseIdx] = interiorDofIdx_;
-                    dnIdx_[phaseIdx] = exteriorDofIdx_;
-                }
-                else if (Vin < Vex) {
-                    upIdx_[phaseIdx] = exteriorDofIdx_;
-                    dnIdx_[phaseIdx] = interiorDofIdx_;
-                }
-                else {
-                    assert(Vin == Vex);
-                    // if the volumes are also equal, we pick the DOF which exhibits the
-                    // smaller global index
-                    if (I < J) {
-                        upIdx_[phaseIdx] = interiorDofIdx_;
-                        dnIdx_[phaseIdx] = exteriorDofIdx_;
-                    }
-                    else {
-                        upIdx_[phaseIdx] = exteriorDofIdx_;
-                        dnIdx_[phaseIdx] = interiorDofIdx_;
-                    }
-                }
+                // larger volume associated to it as upstream DOF. if the volumes are
+                // also equal, we pick the DOF which exhibits the smaller global index
+                upIdx_[phaseIdx] = interiorDofIdx_;
+                dnIdx_[phaseIdx] = exteriorDofIdx_;
+            }
+            else {
+                upIdx_[phaseIdx] = exteriorDofIdx_;
+                dnIdx_[phaseIdx] = interiorDofIdx_;
             }
 
             // apply the threshold pressure for the intersection. note that the concept
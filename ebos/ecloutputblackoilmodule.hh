@@ -44,6 +44,8 @@
 
 #include <dune/common/fvector.hh>
 
+#include <cassert>
+#include <numeric>
 #include <type_traits>
 
 BEGIN_PROPERTIES
@@ -82,6 +84,7 @@ class EclOutputBlackOilModule
     typedef typename GET_PROP_TYPE(TypeTag, MaterialLawParams) MaterialLawParams;
     typedef typename GET_PROP_TYPE(TypeTag, FluidSystem) FluidSystem;
     typedef typename GET_PROP_TYPE(TypeTag, GridView) GridView;
+    typedef typename GET_PROP_TYPE(TypeTag, ThreadManager) ThreadManager;
     typedef typename GridView::template Codim<0>::Entity Element;
     typedef typename GridView::template Codim<0>::Iterator ElementIterator;
 
@@ -813,31 +816,41 @@ public:
         size_t ntFip = *std::max_element(fipnum_.begin(), fipnum_.end());
         ntFip = comm.max(ntFip);
 
-        // sum values over each region
+        // sum the values of all quantities over each region. this is done using a
+        // single pass over the cells and a single global reduction.
+        std::vector<const ScalarBuffer*> cellValues;
+        for (int i = 0; i < FipDataType::numFipValues; i++)
+            cellValues.push_back(&fip_[i]);
+        cellValues.push_back(&pressureTimesPoreVolume_);
+        cellValues.push_back(&hydrocarbonPoreVolume_);
+        cellValues.push_back(&pressureTimesHydrocarbonVolume_);
+        const ScalarBuffer regionTotals = computeFipForAllRegions_(cellValues, ntFip);
+
         ScalarBuffer regionFipValues[FipDataType::numFipValues];
         for (int i = 0; i < FipDataType::numFipValues; i++) {
-            regionFipValues[i] = computeFipForRegions_(fip_[i], fipnum_, ntFip);
+            regionFipValues[i].assign(regionTotals.begin() + i*ntFip,
+                                      regionTotals.begin() + (i + 1)*ntFip);
             if (isIORank_() && origRegionValues_[i].empty())
                 origRegionValues_[i] = regionFipValues[i];
         }
 
-        // sum all region values to compute the field total
-        std::vector<int> fieldNum(ntFip, 1);
-        ScalarBuffer fieldFipValues(FipDataType::numFipValues, 0.0);
-        bool comunicateSum = false; // the regionValues are already summed over all ranks.
-        for (int i = 0; i<FipDataType::numFipValues; i++) {
-            const ScalarBuffer& tmp = computeFipForRegions_(regionFipValues[i], fieldNum, 1, comunicateSum);
-            fieldFipValues[i] = tmp[0];
-        }
+        const int numFip = FipDataType::numFipValues;
+        ScalarBuffer regPressurePv(regionTotals.begin() + numFip*ntFip,
+                                   regionTotals.begin() + (numFip + 1)*ntFip);
+        ScalarBuffer regPvHydrocarbon(regionTotals.begin() + (numFip + 1)*ntFip,
+                                      regionTotals.begin() + (numFip + 2)*ntFip);
+        ScalarBuffer regPressurePvHydrocarbon(regionTotals.begin() + (numFip + 2)*ntFip,
+                                              regionTotals.begin() + (numFip + 3)*ntFip);
 
-        // compute the hydrocarbon averaged pressure over the regions.
-        ScalarBuffer regPressurePv = computeFipForRegions_(pressureTimesPoreVolume_, fipnum_, ntFip);
-        ScalarBuffer regPvHydrocarbon = computeFipForRegions_(hydrocarbonPoreVolume_, fipnum_, ntFip);
-        ScalarBuffer regPressurePvHydrocarbon = computeFipForRegions_(pressureTimesHydrocarbonVolume_, fipnum_, ntFip);
+        // the field totals are the sums of all region values. since these are already
+        // summed over all ranks, no communication is required for this.
+        ScalarBuffer fieldFipValues(FipDataType::numFipValues, 0.0);
+        for (int i = 0; i < FipDataType::numFipValues; i++)
+            fieldFipValues[i] = std::accumulate(regionFipValues[i].begin(), regionFipValues[i].end(), 0.0);
 
-        ScalarBuffer fieldPressurePv = computeFipForRegions_(regPressurePv, fieldNum, 1, comunicateSum);
-        ScalarBuffer fieldPvHydrocarbon = computeFipForRegions_(regPvHydrocarbon, fieldNum, 1, comunicateSum);
-        ScalarBuffer fieldPressurePvHydrocarbon = computeFipForRegions_(regPressurePvHydrocarbon, fieldNum, 1, comunicateSum);
+        ScalarBuffer fieldPressurePv(1, std::accumulate(regPressurePv.begin(), regPressurePv.end(), 0.0));
+        ScalarBuffer fieldPvHydrocarbon(1, std::accumulate(regPvHydrocarbon.begin(), regPvHydrocarbon.end(), 0.0));
+        ScalarBuffer fieldPressurePvHydrocarbon(1, std::accumulate(regPressurePvHydrocarbon.begin(), regPressurePvHydrocarbon.end(), 0.0));
 
         // output on io rank
         // the original Fip values are stored on the first step
@@ -1141,30 +1154,51 @@ private:
         }
     }
 
-    // Sum Fip values over regions.
-    ScalarBuffer computeFipForRegions_(const ScalarBuffer& fip, std::vector<int>& regionId, size_t maxNumberOfRegions, bool commSum = true)
+    // sum up a set of per-cell quantities for each region and over all processes. the
+    // result is a matrix stored in row-major order, i.e., the totals of quantity i for
+    // region j are located at index i*numRegions + j. quantities which are not
+    // computed, i.e., whose cell values are empty, exhibit zero totals.
+    ScalarBuffer computeFipForAllRegions_(const std::vector<const ScalarBuffer*>& cellValues, size_t numRegions) const
     {
-        ScalarBuffer totals(maxNumberOfRegions, 0.0);
-
-        if (fip.empty())
-            return totals;
-
-        assert(regionId.size() == fip.size());
-        for (size_t j = 0; j < regionId.size(); ++j) {
-            const int regionIdx = regionId[j] - 1;
+        size_t numQuantities = cellValues.size();
+        ScalarBuffer totals(numQuantities*numRegions, 0.0);
+
+        // each thread accumulates into its own matrix first. the cells are statically
+        // distributed among the threads and the matrices are reduced in a fixed order,
+        // so the totals do not depend on the timing of the threads.
+        unsigned numThreads = ThreadManager::maxThreads();
+        std::vector<ScalarBuffer> threadTotals(numThreads, ScalarBuffer(numQuantities*numRegions, 0.0));
+
+        int numCells = static_cast<int>(fipnum_.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for (int cellIdx = 0; cellIdx < numCells; ++cellIdx) {
+            const int regionIdx = fipnum_[cellIdx] - 1;
             // the cell is not attributed to any region. ignore it!
             if (regionIdx < 0)
                 continue;
 
-            assert(regionIdx < static_cast<int>(maxNumberOfRegions));
-            totals[regionIdx] += fip[j];
-        }
-        if (commSum) {
-            const auto& comm = simulator_.gridView().comm();
-            for (size_t i = 0; i < maxNumberOfRegions; ++i)
-                totals[i] = comm.sum(totals[i]);
+            assert(regionIdx < static_cast<int>(numRegions));
+            ScalarBuffer& myTotals = threadTotals[ThreadManager::threadId()];
+            for (size_t quantityIdx = 0; quantityIdx < numQuantities; ++quantityIdx) {
+                const ScalarBuffer& values = *cellValues[quantityIdx];
+                if (values.empty())
+                    continue;
+
+                assert(values.size() == fipnum_.size());
+                myTotals[quantityIdx*numRegions + regionIdx] += values[cellIdx];
+            }
         }
 
+        for (unsigned threadIdx = 0; threadIdx < numThreads; ++threadIdx)
+            for (size_t i = 0; i < totals.size(); ++i)
+                totals[i] += threadTotals[threadIdx][i];
+
+        const auto& comm = simulator_.gridView().comm();
+        if (!totals.empty())
+            comm.sum(totals.data(), static_cast<int>(totals.size()));
+
         return totals;
     }
 
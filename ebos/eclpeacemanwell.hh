@@ -43,7 +43,8 @@
 #include <dune/common/version.hh>
 #include <dune/geometry/referenceelements.hh>
 
-#include <map>
+#include <algorithm>
+#include <vector>
 
 namespace Ewoms {
 
@@ -306,11 +307,9 @@ public:
 
         // add the grid DOFs which are influenced by the well, and add the well dof to
         // the ones neighboring the grid ones
-        auto wellDofIt = dofVariables_.begin();
-        const auto& wellDofEndIt = dofVariables_.end();
-        for (; wellDofIt != wellDofEndIt; ++ wellDofIt) {
-            neighbors[wellGlobalDof].insert(wellDofIt->first);
-            neighbors[wellDofIt->first].insert(wellGlobalDof);
+        for (unsigned gridDofIdx : perforatedDofs_) {
+            neighbors[wellGlobalDof].insert(gridDofIdx);
+            neighbors[gridDofIdx].insert(wellGlobalDof);
         }
     }
 
@@ -341,8 +340,6 @@ public:
      */
     virtual void linearize(JacobianMatrix& matrix, GlobalEqVector& residual)
     {
-        const SolutionVector& curSol = simulator_.model().solution(/*timeIdx=*/0);
-
         unsigned wellGlobalDofIdx = AuxModule::localToGlobalDof(/*localDofIdx=*/0);
         residual[wellGlobalDofIdx] = 0.0;
 
@@ -355,11 +352,9 @@ public:
             // if the well is shut, make the auxiliary DOFs a trivial equation in the
             // matrix: the main diagonal is already set to the identity matrix, the
             // off-diagonal matrix entries must be set to 0.
-            auto wellDofIt = dofVariables_.begin();
-            const auto& wellDofEndIt = dofVariables_.end();
-            for (; wellDofIt != wellDofEndIt; ++ wellDofIt) {
-                matrix[wellGlobalDofIdx][wellDofIt->first] = 0.0;
-                matrix[wellDofIt->first][wellGlobalDofIdx] = 0.0;
+            for (unsigned gridDofIdx : perforatedDofs_) {
+                matrix[wellGlobalDofIdx][gridDofIdx] = 0.0;
+                matrix[gridDofIdx][wellGlobalDofIdx] = 0.0;
             }
             matrix[wellGlobalDofIdx][wellGlobalDofIdx] = diagBlock;
             residual[wellGlobalDofIdx] = 0.0;
@@ -372,90 +367,113 @@ public:
             return;
         }
 
-        Scalar wellResid = wellResidual_(actualBottomHolePressure_);
-        residual[wellGlobalDofIdx][0] = wellResid;
+        // the residual of the well equation and its derivative w.r.t. the bottom hole
+        // pressure
+        typedef Opm::DenseAd::Evaluation<Scalar, 1> BhpEval;
+        BhpEval bhpEval(actualBottomHolePressure_);
+        bhpEval.setDerivative(0, 1.0);
+
+        const BhpEval& wellResid = wellResidual_<BhpEval>(bhpEval);
+        residual[wellGlobalDofIdx][0] = wellResid.value();
+        diagBlock[0][0] = wellResid.derivative(0);
 
         // account for the effect of the grid DOFs which are influenced by the well on
-        // the well equation and the effect of the well on the grid DOFs
-        auto wellDofIt = dofVariables_.begin();
-        const auto& wellDofEndIt = dofVariables_.end();
+        // the well equation and the effect of the well on the grid DOFs. since the
+        // quantities of the perforated DOFs are automatically differentiated w.r.t. the
+        // primary variables of their respective DOF, no perturbations are required.
+        //
+        // the well equation only depends on the perforations via the total reservoir
+        // rate and the total surface rates of the phases. thus, the rates of each
+        // perforation are computed once including their derivatives w.r.t. the primary
+        // variables of the perforated DOF, the residual is differentiated w.r.t. the
+        // total rates and the chain rule is applied afterwards.
+        size_t numPerfs = perforatedDofs_.size();
+        perfResvRates_.resize(numPerfs);
+        perfSurfaceRates_.resize(numPerfs);
+
+        typedef Opm::DenseAd::Evaluation<Scalar, numPhases + 1> TotalRateEval;
+        TotalRateEval totalResvRate = 0.0;
+        std::array<TotalRateEval, numPhases> totalSurfaceRates;
+        std::fill(totalSurfaceRates.begin(), totalSurfaceRates.end(), 0.0);
+        for (unsigned perfIdx = 0; perfIdx < numPerfs; ++ perfIdx) {
+            const auto& dofVars = dofVariables_[perfIdx];
+
+            std::array<Evaluation, numPhases> resvRates;
+            computeVolumetricDofRates_(resvRates, actualBottomHolePressure_, dofVars);
+            computeSurfaceRates_(perfSurfaceRates_[perfIdx], resvRates, dofVars, /*withDofDerivatives=*/true);
+            perfResvRates_[perfIdx] = computeWeightedRate_(resvRates);
+
+            totalResvRate += Toolbox::value(perfResvRates_[perfIdx]);
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                if (!FluidSystem::phaseIsActive(phaseIdx))
+                    continue;
+
+                totalSurfaceRates[phaseIdx] += Toolbox::value(perfSurfaceRates_[perfIdx][phaseIdx]);
+            }
+        }
+
+        totalResvRate.setDerivative(0, 1.0);
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            if (FluidSystem::phaseIsActive(phaseIdx))
+                totalSurfaceRates[phaseIdx].setDerivative(1 + phaseIdx, 1.0);
+
+        const TotalRateEval& totalRateWellResid =
+            wellResidualFromRates_<TotalRateEval>(actualBottomHolePressure_,
+                                                  totalResvRate,
+                                                  totalSurfaceRates);
 
         ElementContext elemCtx(simulator_);
-        for (; wellDofIt != wellDofEndIt; ++ wellDofIt) {
-            unsigned gridDofIdx = wellDofIt->first;
-            const auto& dofVars = *dofVariables_[gridDofIdx];
-            DofVariables tmpDofVars(dofVars);
-            auto priVars(curSol[gridDofIdx]);
+        for (unsigned perfIdx = 0; perfIdx < numPerfs; ++ perfIdx) {
+            unsigned gridDofIdx = perforatedDofs_[perfIdx];
+            const auto& dofVars = dofVariables_[perfIdx];
 
             /////////////
             // influence of grid on well
             auto& curBlock = matrix[wellGlobalDofIdx][gridDofIdx];
-
-            elemCtx.updateStencil( dofVars.element );
             curBlock = 0.0;
             for (unsigned priVarIdx = 0; priVarIdx < numModelEq; ++priVarIdx) {
-                // calculate the derivative of the well equation w.r.t. the current
-                // primary variable using forward differences
-                Scalar eps =
-                    1e3
-                    *std::numeric_limits<Scalar>::epsilon()
-                    *std::max<Scalar>(1.0, priVars[priVarIdx]);
-                priVars[priVarIdx] += eps;
-
-                elemCtx.updateIntensiveQuantities(priVars, dofVars.localDofIdx, /*timeIdx=*/0);
-                tmpDofVars.update(elemCtx.intensiveQuantities(dofVars.localDofIdx, /*timeIdx=*/0));
-
-                Scalar dWellEq_dPV =
-                    (wellResidual_(actualBottomHolePressure_, &tmpDofVars, gridDofIdx) - wellResid)
-                    / eps;
-                curBlock[0][priVarIdx] = dWellEq_dPV;
-
-                // go back to the original primary variables
-                priVars[priVarIdx] -= eps;
+                Scalar deriv =
+                    totalRateWellResid.derivative(0)
+                    * perfResvRates_[perfIdx].derivative(priVarIdx);
+
+                for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                    if (!FluidSystem::phaseIsActive(phaseIdx))
+                        continue;
+
+                    deriv +=
+                        totalRateWellResid.derivative(1 + phaseIdx)
+                        * perfSurfaceRates_[perfIdx][phaseIdx].derivative(priVarIdx);
+                }
+
+                curBlock[0][priVarIdx] = deriv;
             }
             //
             /////////////
 
             /////////////
-            // influence of well on grid:
+            // influence of well on grid: the volumetric rates are linear in the bottom
+            // hole pressure and so are the source terms of the model, i.e. it is
+            // sufficient to convert the derivatives of the volumetric rates
             RateVector q(0.0);
             RateVector modelRate;
-            std::array<Scalar, numPhases> resvRates;
+            std::array<BhpEval, numPhases> resvRates;
 
-            elemCtx.updateIntensiveQuantities(priVars, dofVars.localDofIdx, /*timeIdx=*/0);
+            // the intensive quantities are taken from the cache if possible
+            elemCtx.updatePrimaryStencil(dofVars.element);
+            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
 
             const auto& fluidState = elemCtx.intensiveQuantities(dofVars.localDofIdx, /*timeIdx=*/0).fluidState();
 
-            // first, we need the source term of the grid for the slightly disturbed well.
-            Scalar eps =
-                1e3
-                *std::numeric_limits<Scalar>::epsilon()
-                *std::max<Scalar>(1e5, actualBottomHolePressure_);
-            computeVolumetricDofRates_(resvRates, actualBottomHolePressure_ + eps, *dofVariables_[gridDofIdx]);
+            computeVolumetricDofRates_(resvRates, bhpEval, dofVars);
             for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
                 if (!FluidSystem::phaseIsActive(phaseIdx))
                     continue;
 
-                modelRate.setVolumetricRate(fluidState, phaseIdx, resvRates[phaseIdx]);
+                modelRate.setVolumetricRate(fluidState, phaseIdx, resvRates[phaseIdx].derivative(0));
                 for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
                     q[compIdx] += modelRate[compIdx];
             }
 
-            // then, we subtract the source rates for a undisturbed well.
-            computeVolumetricDofRates_(resvRates, actualBottomHolePressure_, *dofVariables_[gridDofIdx]);
-            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-                if (!FluidSystem::phaseIsActive(phaseIdx))
-                    continue;
-
-                modelRate.setVolumetricRate(fluidState, phaseIdx, resvRates[phaseIdx]);
-                for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
-                    q[compIdx] -= modelRate[compIdx];
-            }
-
-            // and finally, we divide by the epsilon to get the derivative
-            for (unsigned eqIdx = 0; eqIdx < numModelEq; ++eqIdx)
-                q[eqIdx] /= eps;
-
             // now we put this derivative into the right place in the Jacobian
             // matrix. This is a bit hacky because it assumes that the model uses a mass
             // rate for each component as its first conservation equation, but we require
@@ -469,21 +487,23 @@ public:
             //
             /////////////
         }
-
-        // effect of changing the well's bottom hole pressure on the well equation
-        Scalar eps =
-            1e3
-            *std::numeric_limits<Scalar>::epsilon()
-            *std::max<Scalar>(1e7, targetBottomHolePressure_);
-        Scalar wellResidStar = wellResidual_(actualBottomHolePressure_ + eps);
-        diagBlock[0][0] = (wellResidStar - wellResid)/eps;
     }
 
 
+    /*!
+     * \copydoc Ewoms::BaseAuxiliaryModule::linearizationIsThreadSafe()
+     *
+     * Each grid DOF is perforated by at most a single well, so the entries of the
+     * Jacobian matrix and of the residual which are written by different wells are
+     * disjoint.
+     */
+    virtual bool linearizationIsThreadSafe() const
+    { return true; }
+
     // reset the well to the initial state, i.e. remove all degrees of freedom...
     void clear()
     {
-        dofVarsStore_.clear();
+        perforatedDofs_.clear();
         dofVariables_.clear();
     }
 
@@ -618,9 +638,12 @@ public:
 
         const auto& dofPos = context.pos(dofIdx, /*timeIdx=*/0);
 
-        dofVarsStore_.push_back(DofVariables());
-        dofVariables_[globalDofIdx] = &dofVarsStore_.back();
-        DofVariables& dofVars = *dofVariables_[globalDofIdx];
+        // keep the perforations sorted by the index of their grid DOF
+        auto perfIt = std::lower_bound(perforatedDofs_.begin(), perforatedDofs_.end(), globalDofIdx);
+        unsigned perfIdx = static_cast<unsigned>(perfIt - perforatedDofs_.begin());
+        perforatedDofs_.insert(perfIt, globalDofIdx);
+        dofVariables_.insert(dofVariables_.begin() + perfIdx, DofVariables());
+        DofVariables& dofVars = dofVariables_[perfIdx];
         wellTotalVolume_ += context.model().dofTotalVolume(globalDofIdx);
 
         dofVars.element = context.element();
@@ -747,7 +770,7 @@ public:
     void setConnectionTransmissibilityFactor(const Context& context, unsigned dofIdx, Scalar value)
     {
         unsigned globalDofIdx = context.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
-        dofVariables_[globalDofIdx]->connectionTransmissibilityFactor = value;
+        dofVariables_[perforationIndex_(globalDofIdx)].connectionTransmissibilityFactor = value;
     }
 
     /*!
@@ -765,7 +788,7 @@ public:
     void setEffectivePermeability(const Context& context, unsigned dofIdx, Scalar value)
     {
         unsigned globalDofIdx = context.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
-        dofVariables_[globalDofIdx].effectivePermeability = value;
+        dofVariables_[perforationIndex_(globalDofIdx)].effectivePermeability = value;
 
         computeConnectionTransmissibilityFactor_(globalDofIdx);
     }
@@ -819,7 +842,7 @@ public:
      *        by the well
      */
     bool applies(unsigned globalDofIdx) const
-    { return dofVariables_.count(globalDofIdx) > 0; }
+    { return perforationIndex_(globalDofIdx) >= 0; }
 
     /*!
      * \brief Set the maximum/minimum bottom hole pressure [Pa] of the well.
@@ -929,7 +952,7 @@ public:
     void setSkinFactor(const Context& context, unsigned dofIdx, Scalar value)
     {
         unsigned globalDofIdx = context.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
-        dofVariables_[globalDofIdx].skinFactor = value;
+        dofVariables_[perforationIndex_(globalDofIdx)].skinFactor = value;
 
         computeConnectionTransmissibilityFactor_(globalDofIdx);
     }
@@ -938,7 +961,7 @@ public:
      * \brief Return the well's skin factor at a DOF [-].
      */
     Scalar skinFactor(unsigned gridDofIdx) const
-    { return dofVariables_.at(gridDofIdx).skinFactor_; }
+    { return dofVariables_.at(perforationIndex_(gridDofIdx)).skinFactor; }
 
     /*!
      * \brief Set the borehole radius of the well
@@ -951,7 +974,7 @@ public:
     void setRadius(const Context& context, unsigned dofIdx, Scalar value)
     {
         unsigned globalDofIdx = context.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
-        dofVariables_[globalDofIdx]->boreholeRadius = value;
+        dofVariables_[perforationIndex_(globalDofIdx)].boreholeRadius = value;
 
         computeConnectionTransmissibilityFactor_(globalDofIdx);
     }
@@ -960,7 +983,7 @@ public:
      * \brief Return the well's radius at a cell [m].
      */
     Scalar radius(unsigned gridDofIdx) const
-    { return dofVariables_.at(gridDofIdx)->radius_; }
+    { return dofVariables_.at(perforationIndex_(gridDofIdx)).boreholeRadius; }
 
     /*!
      * \brief Informs the well that a time step has just begun.
@@ -1021,10 +1044,11 @@ public:
 
         for (unsigned dofIdx = 0; dofIdx < context.numPrimaryDof(timeIdx); ++dofIdx) {
             unsigned globalDofIdx = context.globalSpaceIndex(dofIdx, timeIdx);
-            if (!applies(globalDofIdx))
+            int perfIdx = perforationIndex_(globalDofIdx);
+            if (perfIdx < 0)
                 continue;
 
-            DofVariables& dofVars = *dofVariables_.at(globalDofIdx);
+            DofVariables& dofVars = dofVariables_[perfIdx];
             const auto& intQuants = context.intensiveQuantities(dofIdx, timeIdx);
 
             if (iterationIdx_ == 0)
@@ -1050,7 +1074,7 @@ public:
 
         if (!dofVariables_.empty()) {
             // retrieve the bottom hole pressure from the global system of equations
-            actualBottomHolePressure_ = Toolbox::value(dofVariables_.begin()->second->pressure[0]);
+            actualBottomHolePressure_ = Toolbox::value(dofVariables_.front().pressure[0]);
             actualBottomHolePressure_ = computeRateEquivalentBhp_();
         }
         else
@@ -1129,11 +1153,12 @@ public:
         q = 0.0;
 
         unsigned globalDofIdx = context.globalSpaceIndex(dofIdx, timeIdx);
-        if (wellStatus() == Shut || !applies(globalDofIdx))
+        int perfIdx = perforationIndex_(globalDofIdx);
+        if (wellStatus() == Shut || perfIdx < 0)
             return;
 
         // create a DofVariables object for the current evaluation point
-        DofVariables tmp(*dofVariables_.at(globalDofIdx));
+        DofVariables tmp(dofVariables_[perfIdx]);
 
         tmp.update(context.intensiveQuantities(dofIdx, timeIdx));
 
@@ -1200,11 +1225,21 @@ public:
     }
 
 protected:
+    // returns the index of the perforation for a grid DOF or -1 if the well does not
+    // perforate the DOF
+    int perforationIndex_(unsigned globalDofIdx) const
+    {
+        auto perfIt = std::lower_bound(perforatedDofs_.begin(), perforatedDofs_.end(), globalDofIdx);
+        if (perfIt == perforatedDofs_.end() || *perfIt != globalDofIdx)
+            return -1;
+        return static_cast<int>(perfIt - perforatedDofs_.begin());
+    }
+
     // compute the connection transmissibility factor based on the effective permeability
     // of a connection, the radius of the borehole and the skin factor.
     void computeConnectionTransmissibilityFactor_(unsigned globalDofIdx)
     {
-        auto& dofVars = *dofVariables_[globalDofIdx];
+        auto& dofVars = dofVariables_[perforationIndex_(globalDofIdx)];
 
         const auto& D = dofVars.effectiveSize;
         const auto& K = dofVars.permeability;
@@ -1230,12 +1265,22 @@ protected:
         dofVars.connectionTransmissibilityFactor = exposureFactor*Kh/(std::log(r0 / rWell) + S);
     }
 
+    // convert a solution dependent quantity of a DOF to the type used for the
+    // computations. if derivatives are not requested, the result is a constant.
+    template <class DofEval>
+    static DofEval dofValue_(const Evaluation& value, bool withDerivatives)
+    {
+        if (withDerivatives)
+            return Toolbox::template decay<DofEval>(value);
+        return DofEval(Toolbox::value(value));
+    }
+
     template <class ResultEval, class BhpEval>
     void computeVolumetricDofRates_(std::array<ResultEval, numPhases>& volRates,
                                     const BhpEval& bottomHolePressure,
-                                    const DofVariables& dofVars) const
+                                    const DofVariables& dofVars,
+                                    bool withDofDerivatives = true) const
     {
-        typedef Opm::MathToolbox<Evaluation> DofVarsToolbox;
         typedef typename std::conditional<std::is_same<BhpEval, Scalar>::value,
                                           ResultEval,
                                           Scalar>::type DofEval;
@@ -1259,14 +1304,14 @@ protected:
             // well model due to Peaceman; see Chen et al., p. 449
 
             // phase pressure in grid cell
-            const DofEval& p = DofVarsToolbox::template decay<DofEval>(dofVars.pressure[phaseIdx]);
+            const DofEval& p = dofValue_<DofEval>(dofVars.pressure[phaseIdx], withDofDerivatives);
 
             // density and mobility of fluid phase
-            const DofEval& rho = DofVarsToolbox::template decay<DofEval>(dofVars.density[phaseIdx]);
+            const DofEval& rho = dofValue_<DofEval>(dofVars.density[phaseIdx], withDofDerivatives);
             DofEval lambda;
             if (wellType_ == Producer) {
                 //assert(p < pbh);
-                lambda = DofVarsToolbox::template decay<DofEval>(dofVars.mobility[phaseIdx]);
+                lambda = dofValue_<DofEval>(dofVars.mobility[phaseIdx], withDofDerivatives);
             }
             else if (wellType_ == Injector) {
                 //assert(p > pbh);
@@ -1282,7 +1327,7 @@ protected:
                     if (!FluidSystem::phaseIsActive(phase2Idx))
                         continue;
 
-                    lambda += DofVarsToolbox::template decay<DofEval>(dofVars.mobility[phase2Idx]);
+                    lambda += dofValue_<DofEval>(dofVars.mobility[phase2Idx], withDofDerivatives);
                 }
             }
             else
@@ -1332,13 +1377,20 @@ protected:
      * \brief Convert volumetric reservoir rates into volumetric volume rates.
      *
      * This requires the density and composition of the phases and
-     * thus the applicable fluid state.
+     * thus the applicable fluid state. The derivatives of these w.r.t. the primary
+     * variables of the DOF are only considered if the rates are of the model's
+     * evaluation type and they are explicitly requested.
      */
     template <class Eval>
     void computeSurfaceRates_(std::array<Eval, numPhases>& surfaceRates,
                               const std::array<Eval, numPhases>& reservoirRate,
-                              const DofVariables& dofVars) const
+                              const DofVariables& dofVars,
+                              bool withDofDerivatives = false) const
     {
+        typedef typename std::conditional<std::is_same<Eval, Evaluation>::value,
+                                          Evaluation,
+                                          Scalar>::type DofEval;
+
         // the array for the surface rates and the one for the reservoir rates must not
         // be the same!
         assert(&surfaceRates != &reservoirRate);
@@ -1356,14 +1408,14 @@ protected:
             surfaceRates[oilPhaseIdx] =
                 // oil in gas phase
                 reservoirRate[gasPhaseIdx]
-                * Toolbox::value(dofVars.density[gasPhaseIdx])
-                * Toolbox::value(dofVars.gasMassFraction[oilCompIdx])
+                * dofValue_<DofEval>(dofVars.density[gasPhaseIdx], withDofDerivatives)
+                * dofValue_<DofEval>(dofVars.gasMassFraction[oilCompIdx], withDofDerivatives)
                 / rhoOilSurface
                 +
                 // oil in oil phase
                 reservoirRate[oilPhaseIdx]
-                * Toolbox::value(dofVars.density[oilPhaseIdx])
-                * Toolbox::value(dofVars.oilMassFraction[oilCompIdx])
+                * dofValue_<DofEval>(dofVars.density[oilPhaseIdx], withDofDerivatives)
+                * dofValue_<DofEval>(dofVars.oilMassFraction[oilCompIdx], withDofDerivatives)
                 / rhoOilSurface;
 
         // gas
@@ -1371,21 +1423,21 @@ protected:
             surfaceRates[gasPhaseIdx] =
                 // gas in gas phase
                 reservoirRate[gasPhaseIdx]
-                * Toolbox::value(dofVars.density[gasPhaseIdx])
-                * Toolbox::value(dofVars.gasMassFraction[gasCompIdx])
+                * dofValue_<DofEval>(dofVars.density[gasPhaseIdx], withDofDerivatives)
+                * dofValue_<DofEval>(dofVars.gasMassFraction[gasCompIdx], withDofDerivatives)
                 / rhoGasSurface
                 +
                 // gas in oil phase
                 reservoirRate[oilPhaseIdx]
-                * Toolbox::value(dofVars.density[oilPhaseIdx])
-                * Toolbox::value(dofVars.oilMassFraction[gasCompIdx])
+                * dofValue_<DofEval>(dofVars.density[oilPhaseIdx], withDofDerivatives)
+                * dofValue_<DofEval>(dofVars.oilMassFraction[gasCompIdx], withDofDerivatives)
                 / rhoGasSurface;
 
         // water
         if (FluidSystem::phaseIsActive(waterPhaseIdx))
             surfaceRates[waterPhaseIdx] =
                 reservoirRate[waterPhaseIdx]
-                * Toolbox::value(dofVars.density[waterPhaseIdx])
+                * dofValue_<DofEval>(dofVars.density[waterPhaseIdx], withDofDerivatives)
                 / rhoWaterSurface;
     }
 
@@ -1407,15 +1459,13 @@ protected:
             overallSurfaceRates[phaseIdx] = 0.0;
         }
 
-        auto dofVarsIt = dofVariables_.begin();
-        const auto& dofVarsEndIt = dofVariables_.end();
-        for (; dofVarsIt != dofVarsEndIt; ++ dofVarsIt) {
+        for (unsigned perfIdx = 0; perfIdx < perforatedDofs_.size(); ++ perfIdx) {
             std::array<Scalar, numPhases> volumetricReservoirRates;
             const DofVariables *tmp;
-            if (dofVarsIt->first == globalEvalDofIdx)
+            if (static_cast<int>(perforatedDofs_[perfIdx]) == globalEvalDofIdx)
                 tmp = evalDofVars;
             else
-                tmp = dofVarsIt->second;
+                tmp = &dofVariables_[perfIdx];
 
             computeVolumetricDofRates_<Scalar, Scalar>(volumetricReservoirRates, bottomHolePressure, *tmp);
 
@@ -1529,30 +1579,30 @@ protected:
                                   +"' within " + std::to_string(maxIter) + " iterations.");
     }
 
-    template <class BhpEval>
-    BhpEval wellResidual_(const BhpEval& bhp,
-                          const DofVariables *replacementDofVars = 0,
-                          int replacedGridIdx = -1) const
+    /*!
+     * \brief Compute the residual of the well equation.
+     *
+     * The solution dependent quantities of the perforated DOFs are treated as
+     * constants.
+     */
+    template <class ResultEval, class BhpEval>
+    ResultEval wellResidual_(const BhpEval& bhp) const
     {
-        typedef Opm::MathToolbox<BhpEval> BhpEvalToolbox;
-
         // compute the volumetric reservoir and surface rates for the complete well
-        BhpEval resvRate = 0.0;
+        ResultEval resvRate = 0.0;
 
-        std::array<BhpEval, numPhases> totalSurfaceRates;
+        std::array<ResultEval, numPhases> totalSurfaceRates;
         std::fill(totalSurfaceRates.begin(), totalSurfaceRates.end(), 0.0);
 
-        auto dofVarsIt = dofVariables_.begin();
-        const auto& dofVarsEndIt = dofVariables_.end();
-        for (; dofVarsIt != dofVarsEndIt; ++ dofVarsIt) {
-            std::array<BhpEval, numPhases> resvRates;
-            const DofVariables *dofVars = dofVarsIt->second;
-            if (replacedGridIdx == dofVarsIt->first)
-                dofVars = replacementDofVars;
-            computeVolumetricDofRates_(resvRates, bhp, *dofVars);
+        // the perforations are stored contiguously, so this loop does not involve any
+        // indirections
+        for (unsigned perfIdx = 0; perfIdx < perforatedDofs_.size(); ++ perfIdx) {
+            std::array<ResultEval, numPhases> resvRates;
+            const DofVariables& dofVars = dofVariables_[perfIdx];
+            computeVolumetricDofRates_(resvRates, bhp, dofVars, /*withDofDerivatives=*/false);
 
-            std::array<BhpEval, numPhases> surfaceRates;
-            computeSurfaceRates_(surfaceRates, resvRates, *dofVars);
+            std::array<ResultEval, numPhases> surfaceRates;
+            computeSurfaceRates_(surfaceRates, resvRates, dofVars);
 
             for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
                 if (!FluidSystem::phaseIsActive(phaseIdx))
@@ -1564,7 +1614,21 @@ protected:
             resvRate += computeWeightedRate_(resvRates);
         }
 
-        BhpEval surfaceRate = computeWeightedRate_(totalSurfaceRates);
+        return wellResidualFromRates_<ResultEval>(bhp, resvRate, totalSurfaceRates);
+    }
+
+    /*!
+     * \brief Compute the residual of the well equation given the weighted volumetric
+     *        reservoir rate and the volumetric surface rates of the complete well.
+     */
+    template <class ResultEval, class BhpEval>
+    ResultEval wellResidualFromRates_(const BhpEval& bhp,
+                                      const ResultEval& resvRate,
+                                      const std::array<ResultEval, numPhases>& totalSurfaceRates) const
+    {
+        typedef Opm::MathToolbox<ResultEval> ResultEvalToolbox;
+
+        ResultEval surfaceRate = computeWeightedRate_(totalSurfaceRates);
 
         // compute the residual of well equation. we currently use max(rateMax - rate,
         // bhp - targetBhp) for producers and max(rateMax - rate, bhp - targetBhp) for
@@ -1576,10 +1640,10 @@ protected:
         Opm::Valgrind::CheckDefined(surfaceRate);
         Opm::Valgrind::CheckDefined(resvRate);
 
-        BhpEval result = 1e30;
+        ResultEval result = 1e30;
 
-        BhpEval maxSurfaceRate = maximumSurfaceRate_;
-        BhpEval maxResvRate = maximumReservoirRate_;
+        ResultEval maxSurfaceRate = maximumSurfaceRate_;
+        ResultEval maxResvRate = maximumReservoirRate_;
         if (wellStatus() == Closed) {
             // make the weight of the fluids on the surface equal and require that no
             // fluids are produced on the surface...
@@ -1599,17 +1663,17 @@ protected:
         if (wellType_ == Injector) {
             // for injectors the computed rates are positive and the target BHP is the
             // maximum allowed pressure ...
-            result = BhpEvalToolbox::min(maxSurfaceRate - surfaceRate, result);
-            result = BhpEvalToolbox::min(maxResvRate - resvRate, result);
-            result = BhpEvalToolbox::min(1e-7*(targetBottomHolePressure_ - bhp), result);
+            result = ResultEvalToolbox::min(maxSurfaceRate - surfaceRate, result);
+            result = ResultEvalToolbox::min(maxResvRate - resvRate, result);
+            result = ResultEvalToolbox::min(ResultEval(1e-7*(targetBottomHolePressure_ - bhp)), result);
         }
         else {
             assert(wellType_ == Producer);
             // ... for producers the rates are negative and the bottom hole pressure is
             // is the minimum
-            result = BhpEvalToolbox::min(maxSurfaceRate + surfaceRate, result);
-            result = BhpEvalToolbox::min(maxResvRate + resvRate, result);
-            result = BhpEvalToolbox::min(1e-7*(bhp - targetBottomHolePressure_), result);
+            result = ResultEvalToolbox::min(maxSurfaceRate + surfaceRate, result);
+            result = ResultEvalToolbox::min(maxResvRate + resvRate, result);
+            result = ResultEvalToolbox::min(ResultEval(1e-7*(bhp - targetBottomHolePressure_)), result);
         }
 
         const Scalar scalingFactor = 1e-3;
@@ -1620,8 +1684,17 @@ protected:
 
     std::string name_;
 
-    std::vector<DofVariables, Ewoms::aligned_allocator<DofVariables, alignof(DofVariables)> > dofVarsStore_;
-    std::map<int, DofVariables*> dofVariables_;
+    // the global indices of the grid DOFs perforated by the well in ascending order and
+    // the variables of these perforations in the same order
+    std::vector<unsigned> perforatedDofs_;
+    std::vector<DofVariables, Ewoms::aligned_allocator<DofVariables, alignof(DofVariables)> > dofVariables_;
+
+    // the weighted reservoir rate and the surface rates of each perforation including
+    // their derivatives w.r.t. the primary variables of the perforated DOF. these are
+    // only used by linearize() and kept to avoid allocations.
+    typedef std::array<Evaluation, numPhases> PhaseEvaluations_;
+    std::vector<Evaluation, Ewoms::aligned_allocator<Evaluation, alignof(Evaluation)> > perfResvRates_;
+    std::vector<PhaseEvaluations_, Ewoms::aligned_allocator<PhaseEvaluations_, alignof(PhaseEvaluations_)> > perfSurfaceRates_;
 
     // the number of times beginIteration*() was called for the current time step
     unsigned iterationIdx_;
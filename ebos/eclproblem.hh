@@ -61,6 +61,7 @@
 #include "eclfluxmodule.hh"
 
 #include <ewoms/common/pffgridvector.hh>
+#include <ewoms/parallel/gridcommhandles.hh>
 #include <ewoms/models/blackoil/blackoilmodel.hh>
 #include <ewoms/disc/ecfv/ecfvdiscretization.hh>
 
@@ -68,6 +69,7 @@
 #include <opm/material/thermal/EclThermalLawManager.hpp>
 
 #include <opm/material/fluidstates/CompositionalFluidState.hpp>
+#include <opm/material/fluidstates/SimpleModularFluidState.hpp>
 #include <opm/material/fluidsystems/BlackOilFluidSystem.hpp>
 #include <opm/material/fluidsystems/blackoilpvt/DryGasPvt.hpp>
 #include <opm/material/fluidsystems/blackoilpvt/WetGasPvt.hpp>
@@ -96,6 +98,7 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <cmath>
 
 namespace Ewoms {
 template <class TypeTag>
@@ -133,6 +136,10 @@ NEW_PROP_TAG(EnableDebuggingChecks);
 // thermal gradient specified via the TEMPVD keyword
 NEW_PROP_TAG(EnableThermalFluxBoundaries);
 
+// The minimum change of the saturations of a cell since the last update of its
+// hysteresis parameters which causes these parameters to be updated again
+NEW_PROP_TAG(EclHysteresisSaturationThreshold);
+
 // Set the problem property
 SET_TYPE_PROP(EclBaseProblem, Problem, Ewoms::EclProblem<TypeTag>);
 
@@ -293,6 +300,10 @@ SET_BOOL_PROP(EclBaseProblem, EnableEnergy, false);
 // disable thermal flux boundaries by default
 SET_BOOL_PROP(EclBaseProblem, EnableThermalFluxBoundaries, false);
 
+// by default, the hysteresis parameters of all cells whose saturations changed in any way
+// are updated
+SET_SCALAR_PROP(EclBaseProblem, EclHysteresisSaturationThreshold, 0.0);
+
 END_PROPERTIES
 
 namespace Ewoms {
@@ -390,6 +401,9 @@ public:
                              "Tell the output writer to use double precision. Useful for 'perfect' restarts");
         EWOMS_REGISTER_PARAM(TypeTag, unsigned, RestartWritingInterval,
                              "The frequencies of which time steps are serialized to disk");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, EclHysteresisSaturationThreshold,
+                             "The minimum change of the saturations of a cell which causes "
+                             "its hysteresis parameters to be updated");
     }
 
     /*!
@@ -511,9 +525,6 @@ public:
         if (deck.hasKeyword("VAPPARS")) {
             vapparsActive_ = true;
 
-            size_t numDof = this->model().numGridDof();
-            maxOilSaturation_.resize(numDof, 0.0);
-
             // TODO: update the PVT objects. this is only required if VAPPARS becomes a
             // fully dynamic keyword.
         }
@@ -525,8 +536,6 @@ public:
             drsdtActive_ = !vapparsActive_;
             const auto& drsdtKeyword = deck.getKeyword("DRSDT");
             maxDRsDt_ = drsdtKeyword.getRecord(0).getItem("DRSDT_MAX").getSIDouble(0);
-            size_t numDof = this->model().numGridDof();
-            lastRs_.resize(numDof, 0.0);
 
             std::string drsdtFlag =
                 drsdtKeyword.getRecord(0).getItem("Option").getTrimmedString(0);
@@ -541,10 +550,15 @@ public:
         if (!vapparsActive_ && deck.hasKeyword("DRVDT")) {
             const auto& drvdtKeyword = deck.getKeyword("DVSDT");
             maxDRvDt_ = drvdtKeyword.getRecord(0).getItem("DRVDT_MAX").getSIDouble(0);
-            size_t numDof = this->model().numGridDof();
-            lastRv_.resize(numDof, 0.0);
         }
 
+        // the per-DOF data. the history dependent quantities are only stored if any of
+        // the features which need them is used.
+        size_t numDof = this->model().numGridDof();
+        staticDofData_.resize(numDof, StaticDofData_());
+        if (vapparsActive_ || drsdtActive_ || drvdtActive_ || enablePolymer)
+            dynamicDofData_.resize(numDof, DynamicDofData_());
+
         initFluidSystem_();
         updateElementDepths_();
         readRockParameters_();
@@ -579,13 +593,6 @@ public:
 
         updatePffDofData_();
 
-        if (GET_PROP_VALUE(TypeTag, EnablePolymer)) {
-            const auto& vanguard = this->simulator().vanguard();
-            const auto& gridView = vanguard.gridView();
-            int numElements = gridView.size(/*codim=*/0);
-            maxPolymerAdsorption_.resize(numElements, 0.0);
-        }
-
         if (eclWriter_) {
             eclWriter_->writeInit();
             this->simulator().vanguard().releaseGlobalTransmissibilities();
@@ -883,6 +890,22 @@ public:
         return pffDofData_.get(context.element(), toDofLocalIdx).transmissibility;
     }
 
+    /*!
+     * \brief Returns the precomputed record for the face between the center of an
+     *        element context and one of its neighbors.
+     *
+     * Besides the transmissibility, this contains the threshold pressure, the face
+     * area, the gravity correction term and the upstream decision for equal pressures.
+     */
+    template <class Context>
+    const PffDofData_& faceData(const Context& context,
+                                unsigned OPM_OPTIM_UNUSED fromDofLocalIdx,
+                                unsigned toDofLocalIdx) const
+    {
+        assert(fromDofLocalIdx == 0);
+        return pffDofData_.get(context.element(), toDofLocalIdx);
+    }
+
     /*!
      * \copydoc EclTransmissiblity::transmissibilityBoundary
      */
@@ -944,7 +967,7 @@ public:
     Scalar porosity(const Context& context, unsigned spaceIdx, unsigned timeIdx) const
     {
         unsigned globalSpaceIdx = context.globalSpaceIndex(spaceIdx, timeIdx);
-        return porosity_[globalSpaceIdx];
+        return staticDofData_[globalSpaceIdx].porosity;
     }
 
     /*!
@@ -955,7 +978,7 @@ public:
      * the interface.
      */
     Scalar porosity(unsigned elementIdx) const
-    { return porosity_[elementIdx]; }
+    { return staticDofData_[elementIdx].porosity; }
 
     /*!
      * \brief Returns the depth of an degree of freedom [m]
@@ -967,7 +990,7 @@ public:
     Scalar dofCenterDepth(const Context& context, unsigned spaceIdx, unsigned timeIdx) const
     {
         unsigned globalSpaceIdx = context.globalSpaceIndex(spaceIdx, timeIdx);
-        return elementCenterDepth_[globalSpaceIdx];
+        return staticDofData_[globalSpaceIdx].depth;
     }
 
     /*!
@@ -979,12 +1002,8 @@ public:
         if (rockParams_.empty())
             return 0.0;
 
-        unsigned tableIdx = 0;
-        if (!rockTableIdx_.empty()) {
-            unsigned globalSpaceIdx = context.globalSpaceIndex(spaceIdx, timeIdx);
-            tableIdx = rockTableIdx_[globalSpaceIdx];
-        }
-
+        unsigned globalSpaceIdx = context.globalSpaceIndex(spaceIdx, timeIdx);
+        unsigned tableIdx = staticDofData_[globalSpaceIdx].rockTableIdx;
         return rockParams_[tableIdx].compressibility;
     }
 
@@ -997,12 +1016,8 @@ public:
         if (rockParams_.empty())
             return 1e5;
 
-        unsigned tableIdx = 0;
-        if (!rockTableIdx_.empty()) {
-            unsigned globalSpaceIdx = context.globalSpaceIndex(spaceIdx, timeIdx);
-            tableIdx = rockTableIdx_[globalSpaceIdx];
-        }
-
+        unsigned globalSpaceIdx = context.globalSpaceIndex(spaceIdx, timeIdx);
+        unsigned tableIdx = staticDofData_[globalSpaceIdx].rockTableIdx;
         return rockParams_[tableIdx].referencePressure;
     }
 
@@ -1093,16 +1108,27 @@ public:
      * \brief Returns the index the relevant PVT region given a cell index
      */
     unsigned pvtRegionIndex(unsigned elemIdx) const
+    { return staticDofData_[elemIdx].pvtRegionIdx; }
+
+    /*!
+     * \brief Returns the PVT region index of each element.
+     *
+     * This is a compatibility accessor: the region indices are stored in the per-element
+     * records, so the array is assembled by each call. As before, it is empty if the
+     * deck does not specify the PVTNUM keyword.
+     */
+    std::vector<int> pvtRegionArray() const
     {
-        if (pvtnum_.empty())
-            return 0;
+        const auto& eclProps = this->simulator().vanguard().eclState().get3DProperties();
+        if (!eclProps.hasDeckIntGridProperty("PVTNUM"))
+            return std::vector<int>();
 
-        return pvtnum_[elemIdx];
+        std::vector<int> pvtnum(staticDofData_.size());
+        for (size_t elemIdx = 0; elemIdx < staticDofData_.size(); ++elemIdx)
+            pvtnum[elemIdx] = staticDofData_[elemIdx].pvtRegionIdx;
+        return pvtnum;
     }
 
-    const std::vector<int>& pvtRegionArray() const
-    { return pvtnum_; }
-
     /*!
      * \brief Returns the index of the relevant region for thermodynmic properties
      */
@@ -1114,12 +1140,7 @@ public:
      * \brief Returns the index the relevant saturation function region given a cell index
      */
     unsigned satnumRegionIndex(unsigned elemIdx) const
-    {
-        if (satnum_.empty())
-            return 0;
-
-        return satnum_[elemIdx];
-    }
+    { return staticDofData_[elemIdx].satRegionIdx; }
 
     /*!
      * \brief Returns the index of the relevant region for thermodynmic properties
@@ -1132,12 +1153,7 @@ public:
      * \brief Returns the index the relevant MISC region given a cell index
      */
     unsigned miscnumRegionIndex(unsigned elemIdx) const
-    {
-        if (miscnum_.empty())
-            return 0;
-
-        return miscnum_[elemIdx];
-    }
+    { return staticDofData_[elemIdx].miscRegionIdx; }
 
     /*!
      * \brief Returns the index of the relevant region for thermodynmic properties
@@ -1150,12 +1166,7 @@ public:
      * \brief Returns the index the relevant PLMIXNUM ( for polymer module) region given a cell index
      */
     unsigned plmixnumRegionIndex(unsigned elemIdx) const
-    {
-        if (plmixnum_.empty())
-            return 0;
-
-        return plmixnum_[elemIdx];
-    }
+    { return staticDofData_[elemIdx].plmixRegionIdx; }
 
     /*!
      * \brief Returns the max polymer adsorption value
@@ -1169,10 +1180,10 @@ public:
      */
     Scalar maxPolymerAdsorption(unsigned elemIdx) const
     {
-        if (maxPolymerAdsorption_.empty())
+        if (!enablePolymer)
             return 0;
 
-        return maxPolymerAdsorption_[elemIdx];
+        return dynamicDofData_[elemIdx].maxPolymerAdsorption;
     }
 
 
@@ -1269,6 +1280,10 @@ public:
         // the initial solution.
         thresholdPressures_.finishInit();
 
+        // the threshold pressures are part of the per-face data, so it must be
+        // updated now that they are known
+        updatePffDofData_();
+
         // release the memory of the EQUIL grid since it's no longer needed after this point
         this->simulator().vanguard().releaseEquilGrid();
 
@@ -1312,7 +1327,7 @@ public:
         if (!drsdtActive_ || maxDRs_ < 0.0)
             return std::numeric_limits<Scalar>::max()/2;
 
-        return lastRs_[globalDofIdx] + maxDRs_;
+        return dynamicDofData_[globalDofIdx].lastRs + maxDRs_;
     }
 
     /*!
@@ -1324,7 +1339,7 @@ public:
         if (!drvdtActive_ || maxDRv_ < 0.0)
             return std::numeric_limits<Scalar>::max()/2;
 
-        return lastRv_[globalDofIdx] + maxDRv_;
+        return dynamicDofData_[globalDofIdx].lastRv + maxDRv_;
     }
 
     /*!
@@ -1339,7 +1354,7 @@ public:
         if (!vapparsActive_)
             return 0.0;
 
-        return maxOilSaturation_[globalDofIdx];
+        return dynamicDofData_[globalDofIdx].maxOilSaturation;
     }
 
     /*!
@@ -1356,7 +1371,7 @@ public:
         if (!vapparsActive_)
             return;
 
-        maxOilSaturation_[globalDofIdx] = value;
+        dynamicDofData_[globalDofIdx].maxOilSaturation = value;
     }
 
     /*!
@@ -1405,16 +1420,13 @@ private:
         const auto& gridView = vanguard.gridView();
         const auto& elemMapper = this->elementMapper();;
 
-        int numElements = gridView.size(/*codim=*/0);
-        elementCenterDepth_.resize(numElements);
-
         auto elemIt = gridView.template begin</*codim=*/0>();
         const auto& elemEndIt = gridView.template end</*codim=*/0>();
         for (; elemIt != elemEndIt; ++elemIt) {
             const Element& element = *elemIt;
             const unsigned int elemIdx = elemMapper.index(element);
 
-            elementCenterDepth_[elemIdx] = cellCenterDepth( element );
+            staticDofData_[elemIdx].depth = cellCenterDepth( element );
         }
     }
 
@@ -1441,12 +1453,12 @@ private:
                 typedef typename std::decay<decltype(fs) >::type FluidState;
 
                 if (!dRsDtOnlyFreeGas_ || fs.saturation(gasPhaseIdx) > freeGasMinSaturation_)
-                    lastRs_[compressedDofIdx] =
+                    dynamicDofData_[compressedDofIdx].lastRs =
                         Opm::BlackOil::template getRs_<FluidSystem,
                                                        FluidState,
                                                        Scalar>(fs, iq.pvtRegionIndex());
                 else
-                    lastRs_[compressedDofIdx] = std::numeric_limits<Scalar>::infinity();
+                    dynamicDofData_[compressedDofIdx].lastRs = std::numeric_limits<Scalar>::infinity();
             }
         }
 
@@ -1469,7 +1481,7 @@ private:
 
                 typedef typename std::decay<decltype(fs) >::type FluidState;
 
-                lastRv_[compressedDofIdx] =
+                dynamicDofData_[compressedDofIdx].lastRv =
                     Opm::BlackOil::template getRv_<FluidSystem,
                                                    FluidState,
                                                    Scalar>(fs, iq.pvtRegionIndex());
@@ -1497,7 +1509,8 @@ private:
 
                 Scalar So = Opm::decay<Scalar>(fs.saturation(oilPhaseIdx));
 
-                maxOilSaturation_[compressedDofIdx] = std::max(maxOilSaturation_[compressedDofIdx], So);
+                Scalar& SoMax = dynamicDofData_[compressedDofIdx].maxOilSaturation;
+                SoMax = std::max(SoMax, So);
             }
 
             // we need to invalidate the intensive quantities cache here because the
@@ -1557,12 +1570,11 @@ private:
         const std::vector<int>& tablenumData =
             eclState.get3DProperties().getIntGridProperty(propName).getData();
         unsigned numElem = vanguard.gridView().size(0);
-        rockTableIdx_.resize(numElem);
         for (size_t elemIdx = 0; elemIdx < numElem; ++ elemIdx) {
             unsigned cartElemIdx = vanguard.cartesianIndex(elemIdx);
 
             // reminder: Eclipse uses FORTRAN-style indices
-            rockTableIdx_[elemIdx] = tablenumData[cartElemIdx] - 1;
+            staticDofData_[elemIdx].rockTableIdx = tablenumData[cartElemIdx] - 1;
         }
     }
 
@@ -1626,8 +1638,6 @@ private:
 
         size_t numDof = this->model().numGridDof();
 
-        porosity_.resize(numDof);
-
         const std::vector<double>& porvData =
             props.getDoubleGridProperty("PORV").getData();
         const std::vector<int>& actnumData =
@@ -1669,7 +1679,7 @@ private:
             // be larger than 1.0!
             Scalar dofVolume = this->simulator().model().dofTotalVolume(dofIdx);
             assert(dofVolume > 0.0);
-            porosity_[dofIdx] = poreVolume/dofVolume;
+            staticDofData_[dofIdx].porosity = poreVolume/dofVolume;
         }
     }
 
@@ -1902,29 +1912,111 @@ private:
 
 
 
-    // update the hysteresis parameters of the material laws for the whole grid
+    // update the hysteresis parameters of the material laws of all cells whose
+    // saturations changed since their last update. returns true if the parameters of
+    // any cell were updated on any process.
     bool updateHysteresis_()
     {
         if (!materialLawManager_->enableHysteresis())
             return false;
 
-        // we need to update the hysteresis data for _all_ elements (i.e., not just the
-        // interior ones) to avoid desynchronization of the processes in the parallel case!
-        ElementContext elemCtx(this->simulator());
         const auto& vanguard = this->simulator().vanguard();
-        auto elemIt = vanguard.gridView().template begin</*codim=*/0>();
-        const auto& elemEndIt = vanguard.gridView().template end</*codim=*/0>();
+        const auto& gridView = vanguard.gridView();
+        const auto& elemMapper = this->elementMapper();
+        Scalar threshold = EWOMS_GET_PARAM(TypeTag, Scalar, EclHysteresisSaturationThreshold);
+
+        size_t numDof = this->model().numGridDof();
+        if (hysteresisSaturations_.size() != numDof)
+            // the initial value is outside of the range of valid saturations, so the
+            // parameters of all cells get updated the first time
+            hysteresisSaturations_.resize(numDof, HysteresisSaturations_(-1.0));
+
+        // update the interior cells. if the intensive quantities of a cell are cached,
+        // these are used instead of recomputing them.
+        int anyUpdated = 0;
+        ElementContext elemCtx(this->simulator());
+        auto elemIt = gridView.template begin</*codim=*/0>();
+        const auto& elemEndIt = gridView.template end</*codim=*/0>();
         for (; elemIt != elemEndIt; ++elemIt) {
             const Element& elem = *elemIt;
+            if (elem.partitionType() != Dune::InteriorEntity)
+                continue;
 
-            elemCtx.updatePrimaryStencil(elem);
-            elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+            unsigned compressedDofIdx = elemMapper.index(elem);
+            const auto* intQuants = this->model().cachedIntensiveQuantities(compressedDofIdx,
+                                                                            /*timeIdx=*/0);
+            if (!intQuants) {
+                elemCtx.updatePrimaryStencil(elem);
+                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+                intQuants = &elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
+            }
+            const auto& fs = intQuants->fluidState();
 
-            unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
-            const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
-            materialLawManager_->updateHysteresis(intQuants.fluidState(), compressedDofIdx);
+            auto& lastSat = hysteresisSaturations_[compressedDofIdx];
+            bool saturationsMoved = false;
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+                Scalar S = Opm::scalarValue(fs.saturation(phaseIdx));
+                saturationsMoved = saturationsMoved || std::abs(S - lastSat[phaseIdx]) > threshold;
+            }
+            if (!saturationsMoved)
+                continue;
+
+            materialLawManager_->updateHysteresis(fs, compressedDofIdx);
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                lastSat[phaseIdx] = Opm::scalarValue(fs.saturation(phaseIdx));
+            anyUpdated = 1;
         }
-        return true;
+
+        if (gridView.comm().size() == 1)
+            return anyUpdated;
+
+        // the parameters of the ghost and overlap cells must stay consistent with the
+        // ones of the process which owns the cells. instead of recomputing them, the
+        // saturations which were used for the last update are sent by the owner and the
+        // parameters are updated if they differ from the local ones.
+        auto ownerSaturations = hysteresisSaturations_;
+        typedef GridCommHandleGhostSync<HysteresisSaturations_,
+                                        std::vector<HysteresisSaturations_>,
+                                        DofMapper,
+                                        /*commCodim=*/0> GhostSyncHandle;
+        GhostSyncHandle ghostSync(ownerSaturations, this->model().dofMapper());
+        gridView.communicate(ghostSync,
+                             Dune::InteriorBorder_All_Interface,
+                             Dune::ForwardCommunication);
+
+        typedef Opm::SimpleModularFluidState<Scalar,
+                                             numPhases,
+                                             numComponents,
+                                             FluidSystem,
+                                             /*storePressure=*/false,
+                                             /*storeTemperature=*/false,
+                                             /*storeComposition=*/false,
+                                             /*storeFugacity=*/false,
+                                             /*storeSaturation=*/true,
+                                             /*storeDensity=*/false,
+                                             /*storeViscosity=*/false,
+                                             /*storeEnthalpy=*/false> SatOnlyFluidState;
+        SatOnlyFluidState fs;
+        elemIt = gridView.template begin</*codim=*/0>();
+        for (; elemIt != elemEndIt; ++elemIt) {
+            const Element& elem = *elemIt;
+            if (elem.partitionType() == Dune::InteriorEntity)
+                continue;
+
+            unsigned compressedDofIdx = elemMapper.index(elem);
+            const auto& ownerSat = ownerSaturations[compressedDofIdx];
+            if (ownerSat == hysteresisSaturations_[compressedDofIdx])
+                continue;
+
+            for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+                fs.setSaturation(phaseIdx, ownerSat[phaseIdx]);
+            materialLawManager_->updateHysteresis(fs, compressedDofIdx);
+            hysteresisSaturations_[compressedDofIdx] = ownerSat;
+            anyUpdated = 1;
+        }
+
+        // return whether the parameters of any cell were updated by any process
+        return gridView.comm().max(anyUpdated);
     }
 
     void updateMaxPolymerAdsorption_()
@@ -1943,7 +2035,8 @@ private:
             unsigned compressedDofIdx = elemCtx.globalSpaceIndex(/*spaceIdx=*/0, /*timeIdx=*/0);
             const auto& intQuants = elemCtx.intensiveQuantities(/*spaceIdx=*/0, /*timeIdx=*/0);
 
-            maxPolymerAdsorption_[compressedDofIdx] = std::max(maxPolymerAdsorption_[compressedDofIdx] , Opm::scalarValue(intQuants.polymerAdsorption()));
+            Scalar& maxAdsorption = dynamicDofData_[compressedDofIdx].maxPolymerAdsorption;
+            maxAdsorption = std::max(maxAdsorption, Opm::scalarValue(intQuants.polymerAdsorption()));
         }
     }
 
@@ -1959,10 +2052,9 @@ private:
         const auto& vanguard = this->simulator().vanguard();
 
         unsigned numElems = vanguard.gridView().size(/*codim=*/0);
-        pvtnum_.resize(numElems);
         for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
             unsigned cartElemIdx = vanguard.cartesianIndex(elemIdx);
-            pvtnum_[elemIdx] = pvtnumData[cartElemIdx] - 1;
+            staticDofData_[elemIdx].pvtRegionIdx = pvtnumData[cartElemIdx] - 1;
         }
     }
 
@@ -1978,10 +2070,9 @@ private:
         const auto& vanguard = this->simulator().vanguard();
 
         unsigned numElems = vanguard.gridView().size(/*codim=*/0);
-        satnum_.resize(numElems);
         for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
             unsigned cartElemIdx = vanguard.cartesianIndex(elemIdx);
-            satnum_[elemIdx] = satnumData[cartElemIdx] - 1;
+            staticDofData_[elemIdx].satRegionIdx = satnumData[cartElemIdx] - 1;
         }
     }
 
@@ -1997,10 +2088,9 @@ private:
         const auto& vanguard = this->simulator().vanguard();
 
         unsigned numElems = vanguard.gridView().size(/*codim=*/0);
-        miscnum_.resize(numElems);
         for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
             unsigned cartElemIdx = vanguard.cartesianIndex(elemIdx);
-            miscnum_[elemIdx] = miscnumData[cartElemIdx] - 1;
+            staticDofData_[elemIdx].miscRegionIdx = miscnumData[cartElemIdx] - 1;
         }
     }
 
@@ -2016,17 +2106,48 @@ private:
         const auto& vanguard = this->simulator().vanguard();
 
         unsigned numElems = vanguard.gridView().size(/*codim=*/0);
-        plmixnum_.resize(numElems);
         for (unsigned elemIdx = 0; elemIdx < numElems; ++elemIdx) {
             unsigned cartElemIdx = vanguard.cartesianIndex(elemIdx);
-            plmixnum_[elemIdx] = plmixnumData[cartElemIdx] - 1;
+            staticDofData_[elemIdx].plmixRegionIdx = plmixnumData[cartElemIdx] - 1;
         }
     }
 
+    // the quantities of a degree of freedom which do not change during the
+    // simulation. they are packed into a single object because most of them are
+    // required whenever the intensive quantities of the degree of freedom are updated.
+    struct StaticDofData_
+    {
+        Scalar porosity = 0.0;
+        Scalar depth = 0.0;
+        unsigned short pvtRegionIdx = 0;
+        unsigned short satRegionIdx = 0;
+        unsigned short miscRegionIdx = 0;
+        unsigned short plmixRegionIdx = 0;
+        unsigned short rockTableIdx = 0;
+    };
+
+    // the quantities of a degree of freedom which depend on its history
+    struct DynamicDofData_
+    {
+        Scalar maxOilSaturation = 0.0; // VAPPARS
+        Scalar lastRs = 0.0; // DRSDT
+        Scalar lastRv = 0.0; // DRVDT
+        Scalar maxPolymerAdsorption = 0.0;
+    };
+
     struct PffDofData_
     {
         Opm::ConditionalStorage<enableEnergy, Scalar> thermalHalfTrans;
         Scalar transmissibility;
+        Scalar thresholdPressure;
+        Scalar faceArea;
+
+        // the hydrostatic term of the face, i.e., (depth(in) - depth(ex))*g
+        Scalar gravityDepthTerm;
+
+        // specifies whether the interior DOF is regarded to be upstream if the
+        // pressures on both sides of the face are equal
+        bool interiorUpstreamOnTie;
     };
 
     // update the prefetch friendly data object
@@ -2043,10 +2164,37 @@ private:
             unsigned globalElemIdx = elementMapper.index(stencil.entity(localDofIdx));
             if (localDofIdx != 0) {
                 unsigned globalCenterElemIdx = elementMapper.index(stencil.entity(/*dofIdx=*/0));
-                dofData.transmissibility = transmissibilities_.transmissibility(globalCenterElemIdx, globalElemIdx);
+                unsigned faceIdx = transmissibilities_.faceIndex(globalCenterElemIdx, globalElemIdx);
+                dofData.transmissibility = transmissibilities_.faceTransmissibility(faceIdx);
 
                 if (enableEnergy)
-                    *dofData.thermalHalfTrans = transmissibilities_.thermalHalfTrans(globalCenterElemIdx, globalElemIdx);
+                    *dofData.thermalHalfTrans = transmissibilities_.faceThermalHalfTrans(faceIdx);
+
+                dofData.thresholdPressure =
+                    thresholdPressures_.thresholdPressure(globalCenterElemIdx, globalElemIdx);
+
+                dofData.faceArea = 0.0;
+                for (unsigned scvfIdx = 0; scvfIdx < stencil.numInteriorFaces(); ++scvfIdx) {
+                    const auto& scvf = stencil.interiorFace(scvfIdx);
+                    if (scvf.exteriorIndex() == localDofIdx) {
+                        dofData.faceArea = scvf.area();
+                        break;
+                    }
+                }
+
+                Scalar g = this->gravity()[dimWorld - 1];
+                Scalar distZ =
+                    staticDofData_[globalCenterElemIdx].depth
+                    - staticDofData_[globalElemIdx].depth;
+                dofData.gravityDepthTerm = distZ*g;
+
+                // if the pressures are equal, the DOF with the larger volume is
+                // upstream. if the volumes are also equal, the one with the smaller
+                // global index is.
+                Scalar Vin = stencil.subControlVolume(/*dofIdx=*/0).volume();
+                Scalar Vex = stencil.subControlVolume(localDofIdx).volume();
+                dofData.interiorUpstreamOnTie =
+                    Vin > Vex || (Vin == Vex && globalCenterElemIdx < globalElemIdx);
             }
         };
 
@@ -2055,8 +2203,11 @@ private:
 
     static std::string briefDescription_;
 
-    std::vector<Scalar> porosity_;
-    std::vector<Scalar> elementCenterDepth_;
+    // the static and the history dependent per-DOF quantities. both are indexed by the
+    // global index of the degree of freedom.
+    std::vector<StaticDofData_> staticDofData_;
+    std::vector<DynamicDofData_> dynamicDofData_;
+
     EclTransmissibility<TypeTag> transmissibilities_;
 
     std::shared_ptr<EclMaterialLawManager> materialLawManager_;
@@ -2064,15 +2215,12 @@ private:
 
     EclThresholdPressure<TypeTag> thresholdPressures_;
 
-    std::vector<int> pvtnum_;
-    std::vector<unsigned short> satnum_;
-    std::vector<unsigned short> miscnum_;
-    std::vector<unsigned short> plmixnum_;
-
-    std::vector<unsigned short> rockTableIdx_;
     std::vector<RockParams> rockParams_;
 
-    std::vector<Scalar> maxPolymerAdsorption_;
+    // the saturations of each cell which were used for the last update of its
+    // hysteresis parameters
+    typedef Dune::FieldVector<Scalar, numPhases> HysteresisSaturations_;
+    std::vector<HysteresisSaturations_> hysteresisSaturations_;
 
     bool useMassConservativeInitialCondition_;
     std::vector<InitialFluidState> initialFluidStates_;
@@ -2083,17 +2231,14 @@ private:
 
     bool drsdtActive_; // if no, VAPPARS *might* be active
     bool dRsDtOnlyFreeGas_; // apply the DRSDT rate limit only to cells that exhibit free gas
-    std::vector<Scalar> lastRs_;
     Scalar maxDRsDt_;
     Scalar maxDRs_;
     bool drvdtActive_; // if no, VAPPARS *might* be active
-    std::vector<Scalar> lastRv_;
     Scalar maxDRvDt_;
     Scalar maxDRv_;
     constexpr static Scalar freeGasMinSaturation_ = 1e-7;
 
     bool vapparsActive_; // if no, DRSDT and/or DRVDT *might* be active
-    std::vector<Scalar> maxOilSaturation_;
 
     EclWellModel wellModel_;
 
@@ -35,6 +35,8 @@
 #include <opm/parser/eclipse/EclipseState/Grid/FaceDir.hpp>
 #include <opm/parser/eclipse/EclipseState/Grid/TransMult.hpp>
 
+#include <ewoms/parallel/threadedentityiterator.hh>
+
 #include <opm/grid/CpGrid.hpp>
 
 #include <opm/material/common/Exceptions.hpp>
@@ -46,9 +48,13 @@
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 
+#include <algorithm>
 #include <array>
+#include <exception>
 #include <vector>
-#include <unordered_map>
+#include <string>
+#include <stdexcept>
+#include <cassert>
 
 BEGIN_PROPERTIES
 
@@ -158,196 +164,217 @@ public:
                     axisCentroids[axisIdx][elemIdx][dimIdx] = centroid[dimIdx];
         }
 
-        // reserving some space in the hashmap upfront saves quite a bit of time because
-        // resizes are costly for hashmaps and there would be quite a few of them if we
-        // would not have a rough idea of how large the final map will be (the rough idea
-        // is a conforming Cartesian grid).
-        trans_.clear();
-        trans_.reserve(numElements*3*1.05);
+        // all face quantities are stored in flat arrays which follow the cell-face
+        // adjacency of the grid
+        updateAdjacency_(elemMapper);
 
-        transBoundary_.clear();
+        trans_.assign(neighborIndices_.size(), 0.0);
+        transBoundary_.assign(boundaryOffsets_.back(), 0.0);
 
         // if energy is enabled, let's do the same for the "thermal half transmissibilities"
         if (enableEnergy) {
-            thermalHalfTrans_->clear();
-            thermalHalfTrans_->reserve(numElements*6*1.05);
-
-            thermalHalfTransBoundary_.clear();
+            thermalHalfTrans_->assign(neighborIndices_.size(), 0.0);
+            thermalHalfTransBoundary_.assign(boundaryOffsets_.back(), 0.0);
         }
 
-        // compute the transmissibilities for all intersections
-        elemIt = gridView.template begin</*codim=*/ 0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            const auto& elem = *elemIt;
-            unsigned elemIdx = elemMapper.index(elem);
-
-            auto isIt = gridView.ibegin(elem);
-            const auto& isEndIt = gridView.iend(elem);
-            unsigned boundaryIsIdx = 0;
-            for (; isIt != isEndIt; ++ isIt) {
-                // store intersection, this might be costly
-                const auto& intersection = *isIt;
-
-                // deal with grid boundaries
-                if (intersection.boundary()) {
-                    // compute the transmissibilty for the boundary intersection
-                    const auto& geometry = intersection.geometry();
-                    const auto& faceCenterInside = geometry.center();
-
-                    auto faceAreaNormal = intersection.centerUnitOuterNormal();
-                    faceAreaNormal *= geometry.volume();
-
-                    Scalar transBoundaryIs;
-                    computeHalfTrans_(transBoundaryIs,
-                                      faceAreaNormal,
-                                      intersection.indexInInside(),
-                                      distanceVector_(faceCenterInside,
-                                                      intersection.indexInInside(),
-                                                      elemIdx,
-                                                      axisCentroids),
-                                      permeability_[elemIdx]);
-
-                    // normally there would be two half-transmissibilities that would be
-                    // averaged. on the grid boundary there only is the half
-                    // transmissibility of the interior element.
-                    transBoundary_[std::make_pair(elemIdx, boundaryIsIdx)] = transBoundaryIs;
-
-                    // for boundary intersections we also need to compute the thermal
-                    // half transmissibilities
-                    if (enableEnergy) {
-                        const auto& n = intersection.centerUnitOuterNormal();
-                        const auto& inPos = elem.geometry().center();
-                        const auto& outPos = intersection.geometry().center();
-                        const auto& d = outPos - inPos;
-
-                        // eWoms expects fluxes to be area specific, i.e. we must *not*
-                        // the transmissibility with the face area here
-                        Scalar thermalHalfTrans = std::abs(n*d)/(d*d);
-
-                        thermalHalfTransBoundary_[std::make_pair(elemIdx, boundaryIsIdx)] =
-                            thermalHalfTrans;
+        // compute the transmissibilities for all intersections. each face is only
+        // written by the thread which deals with the element that has the smaller
+        // index, so no locking is required. exceptions must not escape from the
+        // threaded region, so the first one is stored and re-thrown afterwards.
+        std::exception_ptr exc;
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            try {
+                auto threadElemIt = threadedElemIt.beginParallel();
+                for (; !threadedElemIt.isFinished(threadElemIt); threadElemIt = threadedElemIt.increment()) {
+                    const auto& elem = *threadElemIt;
+                    unsigned elemIdx = elemMapper.index(elem);
+
+                    auto isIt = gridView.ibegin(elem);
+                    const auto& isEndIt = gridView.iend(elem);
+                    unsigned boundaryIsIdx = 0;
+                    for (; isIt != isEndIt; ++ isIt) {
+                        // store intersection, this might be costly
+                        const auto& intersection = *isIt;
+
+                        // deal with grid boundaries
+                        if (intersection.boundary()) {
+                            // compute the transmissibilty for the boundary intersection
+                            const auto& geometry = intersection.geometry();
+                            const auto& faceCenterInside = geometry.center();
+
+                            auto faceAreaNormal = intersection.centerUnitOuterNormal();
+                            faceAreaNormal *= geometry.volume();
+
+                            Scalar transBoundaryIs;
+                            computeHalfTrans_(transBoundaryIs,
+                                              faceAreaNormal,
+                                              intersection.indexInInside(),
+                                              distanceVector_(faceCenterInside,
+                                                              intersection.indexInInside(),
+                                                              elemIdx,
+                                                              axisCentroids),
+                                              permeability_[elemIdx]);
+
+                            // normally there would be two half-transmissibilities that would be
+                            // averaged. on the grid boundary there only is the half
+                            // transmissibility of the interior element.
+                            transBoundary_[boundaryOffsets_[elemIdx] + boundaryIsIdx] = transBoundaryIs;
+
+                            // for boundary intersections we also need to compute the thermal
+                            // half transmissibilities
+                            if (enableEnergy) {
+                                const auto& n = intersection.centerUnitOuterNormal();
+                                const auto& inPos = elem.geometry().center();
+                                const auto& outPos = intersection.geometry().center();
+                                const auto& d = outPos - inPos;
+
+                                // eWoms expects fluxes to be area specific, i.e. we must *not*
+                                // the transmissibility with the face area here
+                                Scalar thermalHalfTrans = std::abs(n*d)/(d*d);
+
+                                thermalHalfTransBoundary_[boundaryOffsets_[elemIdx] + boundaryIsIdx] =
+                                    thermalHalfTrans;
+                            }
+
+                            ++ boundaryIsIdx;
+                            continue;
+                        }
+
+                        if (!intersection.neighbor())
+                            // elements can be on process boundaries, i.e. they are not on the
+                            // domain boundary yet they don't have neighbors.
+                            continue;
+
+                        const auto& outsideElem = intersection.outside();
+                        unsigned outsideElemIdx = elemMapper.index(outsideElem);
+
+                        // update the "thermal half transmissibility" for the intersection
+                        if (enableEnergy) {
+                            const auto& n = intersection.centerUnitOuterNormal();
+                            Scalar A = intersection.geometry().volume();
+
+                            const auto& inPos = elem.geometry().center();
+                            const auto& outPos = intersection.geometry().center();
+                            const auto& d = outPos - inPos;
+
+                            (*thermalHalfTrans_)[faceIndex(elemIdx, outsideElemIdx)] =
+                                A * (n*d)/(d*d);
+                        }
+
+                        // we only need to calculate a face's transmissibility
+                        // once...
+                        if (elemIdx > outsideElemIdx)
+                            continue;
+
+                        unsigned insideCartElemIdx = cartMapper.cartesianIndex(elemIdx);
+                        unsigned outsideCartElemIdx = cartMapper.cartesianIndex(outsideElemIdx);
+
+                        // local indices of the faces of the inside and
+                        // outside elements which contain the intersection
+                        unsigned insideFaceIdx  = intersection.indexInInside();
+                        unsigned outsideFaceIdx = intersection.indexInOutside();
+
+                        DimVector faceCenterInside;
+                        DimVector faceCenterOutside;
+                        DimVector faceAreaNormal;
+
+                        typename std::is_same<Grid, Dune::CpGrid>::type isCpGrid;
+                        computeFaceProperties(intersection,
+                                              elemIdx,
+                                              insideFaceIdx,
+                                              outsideElemIdx,
+                                              outsideFaceIdx,
+                                              faceCenterInside,
+                                              faceCenterOutside,
+                                              faceAreaNormal,
+                                              isCpGrid);
+
+                        Scalar halfTrans1;
+                        Scalar halfTrans2;
+
+                        computeHalfTrans_(halfTrans1,
+                                          faceAreaNormal,
+                                          insideFaceIdx,
+                                          distanceVector_(faceCenterInside,
+                                                          intersection.indexInInside(),
+                                                          elemIdx,
+                                                          axisCentroids),
+                                          permeability_[elemIdx]);
+                        computeHalfTrans_(halfTrans2,
+                                          faceAreaNormal,
+                                          outsideFaceIdx,
+                                          distanceVector_(faceCenterOutside,
+                                                          intersection.indexInOutside(),
+                                                          outsideElemIdx,
+                                                          axisCentroids),
+                                          permeability_[outsideElemIdx]);
+
+                        applyNtg_(halfTrans1, insideFaceIdx, insideCartElemIdx, ntg);
+                        applyNtg_(halfTrans2, outsideFaceIdx, outsideCartElemIdx, ntg);
+
+                        // convert half transmissibilities to full face
+                        // transmissibilities using the harmonic mean
+                        Scalar trans;
+                        if (std::abs(halfTrans1) < 1e-30 || std::abs(halfTrans2) < 1e-30)
+                            // avoid division by zero
+                            trans = 0.0;
+                        else
+                            trans = 1.0 / (1.0/halfTrans1 + 1.0/halfTrans2);
+
+                        // apply the full face transmissibility multipliers
+                        // for the inside ...
+                        applyMultipliers_(trans, insideFaceIdx, insideCartElemIdx, transMult);
+                        // ... and outside elements
+                        applyMultipliers_(trans, outsideFaceIdx, outsideCartElemIdx, transMult);
+
+                        // apply the region multipliers (cf. the MULTREGT keyword)
+                        Opm::FaceDir::DirEnum faceDir;
+                        switch (insideFaceIdx) {
+                        case 0:
+                        case 1:
+                            faceDir = Opm::FaceDir::XPlus;
+                            break;
+
+                        case 2:
+                        case 3:
+                            faceDir = Opm::FaceDir::YPlus;
+                            break;
+
+                        case 4:
+                        case 5:
+                            faceDir = Opm::FaceDir::ZPlus;
+                            break;
+
+                        default:
+                            throw std::logic_error("Could not determine a face direction");
+                        }
+
+                        trans *= transMult.getRegionMultiplier(insideCartElemIdx,
+                                                               outsideCartElemIdx,
+                                                               faceDir);
+
+                        // the transmissibility is symmetric, but it is stored for both
+                        // directions to keep the arrays aligned with the adjacency
+                        trans_[faceIndex(elemIdx, outsideElemIdx)] = trans;
+                        trans_[faceIndex(outsideElemIdx, elemIdx)] = trans;
                     }
-
-                    ++ boundaryIsIdx;
-                    continue;
                 }
-
-                if (!intersection.neighbor())
-                    // elements can be on process boundaries, i.e. they are not on the
-                    // domain boundary yet they don't have neighbors.
-                    continue;
-
-                const auto& outsideElem = intersection.outside();
-                unsigned outsideElemIdx = elemMapper.index(outsideElem);
-
-                // update the "thermal half transmissibility" for the intersection
-                if (enableEnergy) {
-                    const auto& n = intersection.centerUnitOuterNormal();
-                    Scalar A = intersection.geometry().volume();
-
-                    const auto& inPos = elem.geometry().center();
-                    const auto& outPos = intersection.geometry().center();
-                    const auto& d = outPos - inPos;
-
-                    (*thermalHalfTrans_)[directionalIsId_(elemIdx, outsideElemIdx)] =
-                        A * (n*d)/(d*d);
-                }
-
-                // we only need to calculate a face's transmissibility
-                // once...
-                if (elemIdx > outsideElemIdx)
-                    continue;
-
-                unsigned insideCartElemIdx = cartMapper.cartesianIndex(elemIdx);
-                unsigned outsideCartElemIdx = cartMapper.cartesianIndex(outsideElemIdx);
-
-                // local indices of the faces of the inside and
-                // outside elements which contain the intersection
-                unsigned insideFaceIdx  = intersection.indexInInside();
-                unsigned outsideFaceIdx = intersection.indexInOutside();
-
-                DimVector faceCenterInside;
-                DimVector faceCenterOutside;
-                DimVector faceAreaNormal;
-
-                typename std::is_same<Grid, Dune::CpGrid>::type isCpGrid;
-                computeFaceProperties(intersection,
-                                      elemIdx,
-                                      insideFaceIdx,
-                                      outsideElemIdx,
-                                      outsideFaceIdx,
-                                      faceCenterInside,
-                                      faceCenterOutside,
-                                      faceAreaNormal,
-                                      isCpGrid);
-
-                Scalar halfTrans1;
-                Scalar halfTrans2;
-
-                computeHalfTrans_(halfTrans1,
-                                  faceAreaNormal,
-                                  insideFaceIdx,
-                                  distanceVector_(faceCenterInside,
-                                                  intersection.indexInInside(),
-                                                  elemIdx,
-                                                  axisCentroids),
-                                  permeability_[elemIdx]);
-                computeHalfTrans_(halfTrans2,
-                                  faceAreaNormal,
-                                  outsideFaceIdx,
-                                  distanceVector_(faceCenterOutside,
-                                                  intersection.indexInOutside(),
-                                                  outsideElemIdx,
-                                                  axisCentroids),
-                                  permeability_[outsideElemIdx]);
-
-                applyNtg_(halfTrans1, insideFaceIdx, insideCartElemIdx, ntg);
-                applyNtg_(halfTrans2, outsideFaceIdx, outsideCartElemIdx, ntg);
-
-                // convert half transmissibilities to full face
-                // transmissibilities using the harmonic mean
-                Scalar trans;
-                if (std::abs(halfTrans1) < 1e-30 || std::abs(halfTrans2) < 1e-30)
-                    // avoid division by zero
-                    trans = 0.0;
-                else
-                    trans = 1.0 / (1.0/halfTrans1 + 1.0/halfTrans2);
-
-                // apply the full face transmissibility multipliers
-                // for the inside ...
-                applyMultipliers_(trans, insideFaceIdx, insideCartElemIdx, transMult);
-                // ... and outside elements
-                applyMultipliers_(trans, outsideFaceIdx, outsideCartElemIdx, transMult);
-
-                // apply the region multipliers (cf. the MULTREGT keyword)
-                Opm::FaceDir::DirEnum faceDir;
-                switch (insideFaceIdx) {
-                case 0:
-                case 1:
-                    faceDir = Opm::FaceDir::XPlus;
-                    break;
-
-                case 2:
-                case 3:
-                    faceDir = Opm::FaceDir::YPlus;
-                    break;
-
-                case 4:
-                case 5:
-                    faceDir = Opm::FaceDir::ZPlus;
-                    break;
-
-                default:
-                    throw std::logic_error("Could not determine a face direction");
-                }
-
-                trans *= transMult.getRegionMultiplier(insideCartElemIdx,
-                                                       outsideCartElemIdx,
-                                                       faceDir);
-
-                trans_[isId_(elemIdx, outsideElemIdx)] = trans;
+            }
+            catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                if (!exc)
+                    exc = std::current_exception();
             }
         }
+
+        if (exc)
+            std::rethrow_exception(exc);
     }
 
     /*!
@@ -356,17 +383,60 @@ public:
     const DimMatrix& permeability(unsigned elemIdx) const
     { return permeability_[elemIdx]; }
 
+    /*!
+     * \brief Return the offsets of the rows of the cell-face adjacency.
+     *
+     * The neighbors of the element with index i are stored at the positions
+     * [neighborOffsets()[i], neighborOffsets()[i + 1]) of neighborIndices(). These
+     * positions are the face indices which can be passed to the face*() methods.
+     */
+    const std::vector<unsigned>& neighborOffsets() const
+    { return neighborOffsets_; }
+
+    /*!
+     * \brief Return the indices of the neighboring elements of all elements.
+     *
+     * Within a row, the neighbors are sorted by their index, i.e., the layout matches
+     * the sparsity pattern of the Jacobian matrix without its diagonal.
+     */
+    const std::vector<unsigned>& neighborIndices() const
+    { return neighborIndices_; }
+
+    /*!
+     * \brief Return the index of the face from an element to one of its neighbors.
+     */
+    unsigned faceIndex(unsigned elemIdx1, unsigned elemIdx2) const
+    {
+        const auto& rowBegin = neighborIndices_.begin() + neighborOffsets_[elemIdx1];
+        const auto& rowEnd = neighborIndices_.begin() + neighborOffsets_[elemIdx1 + 1];
+        const auto& it = std::lower_bound(rowBegin, rowEnd, elemIdx2);
+        if (it == rowEnd || *it != elemIdx2)
+            throw std::out_of_range("Elements "+std::to_string(elemIdx1)+" and "
+                                    +std::to_string(elemIdx2)+" are not neighbors");
+
+        return static_cast<unsigned>(it - neighborIndices_.begin());
+    }
+
+    /*!
+     * \brief Return the transmissibility for a face given by its index.
+     */
+    Scalar faceTransmissibility(unsigned faceIdx) const
+    { return trans_[faceIdx]; }
+
     /*!
      * \brief Return the transmissibility for the intersection between two elements.
      */
     Scalar transmissibility(unsigned elemIdx1, unsigned elemIdx2) const
-    { return trans_.at(isId_(elemIdx1, elemIdx2)); }
+    { return trans_[faceIndex(elemIdx1, elemIdx2)]; }
 
     /*!
      * \brief Return the transmissibility for a given boundary segment.
      */
     Scalar transmissibilityBoundary(unsigned elemIdx, unsigned boundaryFaceIdx) const
-    { return transBoundary_.at(std::make_pair(elemIdx, boundaryFaceIdx)); }
+    {
+        assert(boundaryOffsets_[elemIdx] + boundaryFaceIdx < boundaryOffsets_[elemIdx + 1]);
+        return transBoundary_[boundaryOffsets_[elemIdx] + boundaryFaceIdx];
+    }
 
     /*!
      * \brief Return the thermal "half transmissibility" for the intersection between two
@@ -383,10 +453,19 @@ public:
      * cell and the center of the intersection.
      */
     Scalar thermalHalfTrans(unsigned insideElemIdx, unsigned outsideElemIdx) const
-    { return thermalHalfTrans_->at(directionalIsId_(insideElemIdx, outsideElemIdx)); }
+    { return (*thermalHalfTrans_)[faceIndex(insideElemIdx, outsideElemIdx)]; }
+
+    /*!
+     * \brief Return the thermal "half transmissibility" for a face given by its index.
+     */
+    Scalar faceThermalHalfTrans(unsigned faceIdx) const
+    { return (*thermalHalfTrans_)[faceIdx]; }
 
     Scalar thermalHalfTransBoundary(unsigned insideElemIdx, unsigned boundaryFaceIdx) const
-    { return thermalHalfTransBoundary_.at(std::make_pair(insideElemIdx, boundaryFaceIdx)); }
+    {
+        assert(boundaryOffsets_[insideElemIdx] + boundaryFaceIdx < boundaryOffsets_[insideElemIdx + 1]);
+        return thermalHalfTransBoundary_[boundaryOffsets_[insideElemIdx] + boundaryFaceIdx];
+    }
 
 private:
     template <class Intersection>
@@ -462,21 +541,74 @@ private:
                                    "(The PERM{X,Y,Z} keywords are missing)");
     }
 
-    std::uint64_t isId_(unsigned elemIdx1, unsigned elemIdx2) const
+    // determine the neighbors and the number of boundary intersections of all elements
+    void updateAdjacency_(const ElementMapper& elemMapper)
     {
-        static const unsigned elemIdxShift = 32; // bits
+        const auto& gridView = vanguard_.gridView();
+        unsigned numElements = elemMapper.size();
 
-        unsigned elemAIdx = std::min(elemIdx1, elemIdx2);
-        std::uint64_t elemBIdx = std::max(elemIdx1, elemIdx2);
+        neighborOffsets_.assign(numElements + 1, 0);
+        boundaryOffsets_.assign(numElements + 1, 0);
 
-        return (elemBIdx<<elemIdxShift) + elemAIdx;
-    }
+        // count the intersections of each element
+        const auto& elemEndIt = gridView.template end</*codim=*/ 0>();
+        for (auto elemIt = gridView.template begin</*codim=*/ 0>(); elemIt != elemEndIt; ++elemIt) {
+            const auto& elem = *elemIt;
+            unsigned elemIdx = elemMapper.index(elem);
 
-    std::uint64_t directionalIsId_(unsigned elemIdx1, unsigned elemIdx2) const
-    {
-        static const unsigned elemIdxShift = 32; // bits
+            auto isIt = gridView.ibegin(elem);
+            const auto& isEndIt = gridView.iend(elem);
+            for (; isIt != isEndIt; ++ isIt) {
+                const auto& intersection = *isIt;
+                if (intersection.boundary())
+                    ++ boundaryOffsets_[elemIdx + 1];
+                else if (intersection.neighbor())
+                    ++ neighborOffsets_[elemIdx + 1];
+            }
+        }
+
+        for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+            neighborOffsets_[elemIdx + 1] += neighborOffsets_[elemIdx];
+            boundaryOffsets_[elemIdx + 1] += boundaryOffsets_[elemIdx];
+        }
+
+        // collect the neighbors
+        neighborIndices_.resize(neighborOffsets_.back());
+        std::vector<unsigned> fillPos(neighborOffsets_.begin(), neighborOffsets_.end() - 1);
+        for (auto elemIt = gridView.template begin</*codim=*/ 0>(); elemIt != elemEndIt; ++elemIt) {
+            const auto& elem = *elemIt;
+            unsigned elemIdx = elemMapper.index(elem);
 
-        return (std::uint64_t(elemIdx1)<<elemIdxShift) + elemIdx2;
+            auto isIt = gridView.ibegin(elem);
+            const auto& isEndIt = gridView.iend(elem);
+            for (; isIt != isEndIt; ++ isIt) {
+                const auto& intersection = *isIt;
+                if (intersection.boundary() || !intersection.neighbor())
+                    continue;
+
+                neighborIndices_[fillPos[elemIdx]++] = elemMapper.index(intersection.outside());
+            }
+        }
+
+        // sort the neighbors of each element and remove duplicates, i.e., elements
+        // which share more than a single intersection
+        unsigned rowBegin = 0;
+        unsigned writePos = 0;
+        for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+            unsigned rowEnd = neighborOffsets_[elemIdx + 1];
+            auto beginIt = neighborIndices_.begin() + rowBegin;
+            auto endIt = neighborIndices_.begin() + rowEnd;
+            std::sort(beginIt, endIt);
+            endIt = std::unique(beginIt, endIt);
+
+            neighborOffsets_[elemIdx] = writePos;
+            for (auto it = beginIt; it != endIt; ++it)
+                neighborIndices_[writePos++] = *it;
+
+            rowBegin = rowEnd;
+        }
+        neighborOffsets_[numElements] = writePos;
+        neighborIndices_.resize(writePos);
     }
 
     void computeHalfTrans_(Scalar& halfTrans,
@@ -611,11 +743,13 @@ private:
 
     const Vanguard& vanguard_;
     std::vector<DimMatrix> permeability_;
-    std::unordered_map<std::uint64_t, Scalar> trans_;
-    std::map<std::pair<unsigned, unsigned>, Scalar> transBoundary_;
-    std::map<std::pair<unsigned, unsigned>, Scalar> thermalHalfTransBoundary_;
-    Opm::ConditionalStorage<enableEnergy,
-                            std::unordered_map<std::uint64_t, Scalar> > thermalHalfTrans_;
+    std::vector<unsigned> neighborOffsets_;
+    std::vector<unsigned> neighborIndices_;
+    std::vector<unsigned> boundaryOffsets_;
+    std::vector<Scalar> trans_;
+    std::vector<Scalar> transBoundary_;
+    std::vector<Scalar> thermalHalfTransBoundary_;
+    Opm::ConditionalStorage<enableEnergy, std::vector<Scalar> > thermalHalfTrans_;
 };
 
 } // namespace Ewoms
@@ -47,6 +47,8 @@
 
 #include <dune/grid/common/gridenums.hh>
 
+#include <algorithm>
+#include <exception>
 #include <map>
 #include <string>
 #include <vector>
@@ -84,6 +86,7 @@ class EclWellManager
     enum { gasPhaseIdx = FluidSystem::gasPhaseIdx };
 
     typedef typename GridView::template Codim<0>::Entity Element;
+    typedef typename Element::EntitySeed ElementSeed;
 
     typedef Ewoms::EclPeacemanWell<TypeTag> Well;
 
@@ -138,7 +141,12 @@ public:
         computeWellConnectionsMap_(episodeIdx, wellCompMap);
 
         if (wasRestarted || wellTopologyChanged_(eclState, deckSchedule, episodeIdx))
-            updateWellTopology_(episodeIdx, wellCompMap, gridDofIsPenetrated_);
+            updateWellTopology_(episodeIdx,
+                                wellCompMap,
+                                gridDofIsPenetrated_,
+                                perforatedElementSeeds_,
+                                perforatedElementWellOffsets_,
+                                perforatedElementWells_);
 
         // set those parameters of the wells which do not change the topology of the
         // linearized system of equations
@@ -400,35 +408,94 @@ public:
      */
     void beginIteration()
     {
-        // call the preprocessing routines
-        const size_t wellSize = wells_.size();
-        for (size_t wellIdx = 0; wellIdx < wellSize; ++wellIdx)
-            wells_[wellIdx]->beginIterationPreProcess();
+        // call the preprocessing routines. exceptions must not escape from the
+        // threaded loops of this method, so the first one is stored and re-thrown
+        // after the respective loop.
+        int wellSize = static_cast<int>(wells_.size());
+        int succeeded = 1;
+        std::exception_ptr exc;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(min:succeeded)
+#endif
+        for (int wellIdx = 0; wellIdx < wellSize; ++wellIdx) {
+            try {
+                wells_[wellIdx]->beginIterationPreProcess();
+            }
+            catch (...) {
+                succeeded = 0;
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                if (!exc)
+                    exc = std::current_exception();
+            }
+        }
+
+        if (!succeeded)
+            std::rethrow_exception(exc);
 
-        // call the accumulation routines
-        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(simulator_.vanguard().gridView());
+        // call the accumulation routines. only the elements which are perforated by at
+        // least one well need to be visited for this.
+        const auto& grid = simulator_.vanguard().gridView().grid();
+        int numPerforatedElements = static_cast<int>(perforatedElementSeeds_.size());
 #ifdef _OPENMP
-#pragma omp parallel
+#pragma omp parallel reduction(min:succeeded)
 #endif
         {
+            // Attention: the variables below are thread specific and thus cannot be
+            // moved in front of the #pragma!
             ElementContext elemCtx(simulator_);
-            auto elemIt = threadedElemIt.beginParallel();
-            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
-                const Element& elem = *elemIt;
-                if (elem.partitionType() != Dune::InteriorEntity)
-                    continue;
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+            for (int perfElemIdx = 0; perfElemIdx < numPerforatedElements; ++perfElemIdx) {
+                try {
+                    const Element elem = grid.entity(perforatedElementSeeds_[perfElemIdx]);
+
+                    // the intensive quantities are taken from the cache if it is enabled
+                    elemCtx.updatePrimaryStencil(elem);
+                    elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+
+                    unsigned beginIdx = perforatedElementWellOffsets_[perfElemIdx];
+                    unsigned endIdx = perforatedElementWellOffsets_[perfElemIdx + 1];
+                    for (unsigned i = beginIdx; i < endIdx; ++i)
+                        perforatedElementWells_[i]->beginIterationAccumulate(elemCtx, /*timeIdx=*/0);
+                }
+                catch (...) {
+                    succeeded = 0;
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                    if (!exc)
+                        exc = std::current_exception();
+                }
+            }
+        }
 
-                elemCtx.updatePrimaryStencil(elem);
-                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/0);
+        if (!succeeded)
+            std::rethrow_exception(exc);
 
-                for (size_t wellIdx = 0; wellIdx < wellSize; ++wellIdx)
-                    wells_[wellIdx]->beginIterationAccumulate(elemCtx, /*timeIdx=*/0);
+        // call the postprocessing routines. these may throw Opm::NumericalIssue if
+        // the rate-equivalent bottom hole pressure of a well cannot be determined.
+#ifdef _OPENMP
+#pragma omp parallel for reduction(min:succeeded)
+#endif
+        for (int wellIdx = 0; wellIdx < wellSize; ++wellIdx) {
+            try {
+                wells_[wellIdx]->beginIterationPostProcess();
+            }
+            catch (...) {
+                succeeded = 0;
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                if (!exc)
+                    exc = std::current_exception();
             }
         }
 
-        // call the postprocessing routines
-        for (size_t wellIdx = 0; wellIdx < wellSize; ++wellIdx)
-            wells_[wellIdx]->beginIterationPostProcess();
+        if (!succeeded)
+            std::rethrow_exception(exc);
     }
 
     /*!
@@ -631,7 +698,10 @@ protected:
 
     void updateWellTopology_(unsigned reportStepIdx OPM_UNUSED,
                              const WellConnectionsMap& wellConnections,
-                             std::vector<bool>& gridDofIsPenetrated) const
+                             std::vector<bool>& gridDofIsPenetrated,
+                             std::vector<ElementSeed>& perforatedElementSeeds,
+                             std::vector<unsigned>& perforatedElementWellOffsets,
+                             std::vector<Well*>& perforatedElementWells) const
     {
         auto& model = simulator_.model();
         const auto& vanguard = simulator_.vanguard();
@@ -652,6 +722,12 @@ protected:
         gridDofIsPenetrated.resize(model.numGridDof());
         std::fill(gridDofIsPenetrated.begin(), gridDofIsPenetrated.end(), false);
 
+        // the index of the perforated elements: for each of them, the wells which
+        // perforate it are stored in a compressed row format
+        perforatedElementSeeds.clear();
+        perforatedElementWells.clear();
+        perforatedElementWellOffsets.assign(1, 0);
+
         ElementContext elemCtx(simulator_);
         auto elemIt = gridView.template begin</*codim=*/0>();
         const auto elemEndIt = gridView.template end</*codim=*/0>();
@@ -677,6 +753,19 @@ protected:
                 eclWell->addDof(elemCtx, dofIdx);
 
                 wells.insert(eclWell);
+
+                // add the well to the list of wells of the element if it is not
+                // already in there
+                auto elemWellsBegin =
+                    perforatedElementWells.begin() + perforatedElementWellOffsets.back();
+                if (std::find(elemWellsBegin, perforatedElementWells.end(), eclWell.get())
+                    == perforatedElementWells.end())
+                    perforatedElementWells.push_back(eclWell.get());
+            }
+
+            if (perforatedElementWells.size() > perforatedElementWellOffsets.back()) {
+                perforatedElementSeeds.push_back(elem.seed());
+                perforatedElementWellOffsets.push_back(perforatedElementWells.size());
             }
             //////
         }
@@ -821,6 +910,9 @@ protected:
 
     std::vector<std::shared_ptr<Well> > wells_;
     std::vector<bool> gridDofIsPenetrated_;
+    std::vector<ElementSeed> perforatedElementSeeds_;
+    std::vector<unsigned> perforatedElementWellOffsets_;
+    std::vector<Well*> perforatedElementWells_;
     std::map<std::string, int> wellNameToIndex_;
     std::map<std::string, std::array<Scalar, numPhases> > wellTotalInjectedVolume_;
     std::map<std::string, std::array<Scalar, numPhases> > wellTotalProducedVolume_;
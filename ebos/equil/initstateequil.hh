@@ -54,8 +54,17 @@
 #include <opm/material/fluidstates/SimpleModularFluidState.hpp>
 #include <opm/material/fluidmatrixinteractions/EclMaterialLawManager.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cmath>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -78,74 +87,140 @@ namespace Ewoms {
  */
 namespace EQUIL {
 namespace Details {
+/**
+ * Solve an initial value problem using an adaptive embedded
+ * Runge-Kutta method.
+ *
+ * The solution is advanced by the Dormand-Prince 5(4) pair whose
+ * step size is controlled by the estimate of the local error. Values
+ * in between the accepted steps are computed using the fourth order
+ * continuous extension of the method (cf. Hairer, Norsett, Wanner:
+ * "Solving Ordinary Differential Equations I", section II.6).
+ */
 template <class RHS>
-class RK4IVP {
+class AdaptiveRKIVP {
 public:
-    RK4IVP(const RHS& f,
-           const std::array<double,2>& span,
-           const double y0,
-           const int N)
-        : N_(N)
-        , span_(span)
+    AdaptiveRKIVP(const RHS& f,
+                  const std::array<double,2>& span,
+                  const double y0,
+                  const double relTol = 1e-10,
+                  const double absTol = 1e-6)
+        : x0_(span[0])
+        , dir_((span[1] < span[0]) ? -1.0 : 1.0)
+        , y0_(y0)
     {
-        const double h = stepsize();
-        const double h2 = h / 2;
-        const double h6 = h / 6;
-
-        y_.reserve(N + 1);
-        f_.reserve(N + 1);
-
-        y_.push_back(y0);
-        f_.push_back(f(span_[0], y0));
-
-        for (int i = 0; i < N; ++i) {
-            const double x = span_[0] + i*h;
-            const double y = y_.back();
+        // Butcher tableau of the Dormand-Prince method
+        static const double c2 = 1.0/5, c3 = 3.0/10, c4 = 4.0/5, c5 = 8.0/9;
+        static const double a21 = 1.0/5;
+        static const double a31 = 3.0/40, a32 = 9.0/40;
+        static const double a41 = 44.0/45, a42 = -56.0/15, a43 = 32.0/9;
+        static const double a51 = 19372.0/6561, a52 = -25360.0/2187, a53 = 64448.0/6561,
+            a54 = -212.0/729;
+        static const double a61 = 9017.0/3168, a62 = -355.0/33, a63 = 46732.0/5247,
+            a64 = 49.0/176, a65 = -5103.0/18656;
+        static const double a71 = 35.0/384, a73 = 500.0/1113, a74 = 125.0/192,
+            a75 = -2187.0/6784, a76 = 11.0/84;
+
+        // difference between the fifth and the fourth order solutions
+        static const double e1 = 71.0/57600, e3 = -71.0/16695, e4 = 71.0/1920,
+            e5 = -17253.0/339200, e6 = 22.0/525, e7 = -1.0/40;
+
+        // coefficients of the continuous extension
+        static const double d1 = -12715105075.0/11282082432, d3 = 87487479700.0/32700410799,
+            d4 = -10690763975.0/1880347072, d5 = 701980252875.0/199316789632,
+            d6 = -1453857185.0/822651844, d7 = 69997945.0/29380423;
+
+        const double length = std::abs(span[1] - span[0]);
+        const double hMin = 1e-12*length;
+
+        double t = 0.0;
+        double y = y0;
+        double k1 = f(x0_, y);
+        double h = length/100;
+
+        t_.push_back(t);
+        while (t < length) {
+            h = std::min(h, length - t);
+
+            const double x = x0_ + dir_*t;
+            const double hs = dir_*h;
+            const double k2 = f(x + c2*hs, y + hs*(a21*k1));
+            const double k3 = f(x + c3*hs, y + hs*(a31*k1 + a32*k2));
+            const double k4 = f(x + c4*hs, y + hs*(a41*k1 + a42*k2 + a43*k3));
+            const double k5 = f(x + c5*hs, y + hs*(a51*k1 + a52*k2 + a53*k3 + a54*k4));
+            const double k6 = f(x + hs, y + hs*(a61*k1 + a62*k2 + a63*k3 + a64*k4 + a65*k5));
+            const double yNew = y + hs*(a71*k1 + a73*k3 + a74*k4 + a75*k5 + a76*k6);
+            const double k7 = f(x + hs, yNew);
+
+            const double errEst = hs*(e1*k1 + e3*k3 + e4*k4 + e5*k5 + e6*k6 + e7*k7);
+            const double scale = absTol + relTol*std::max(std::abs(y), std::abs(yNew));
+            const double err = std::abs(errEst)/scale;
+
+            // a non-finite error estimate means that the right hand side could not be
+            // evaluated for this step. retry with a smaller step until the minimum step
+            // size is reached.
+            if (!std::isfinite(err)) {
+                if (h <= hMin)
+                    throw std::runtime_error("Cannot integrate the phase pressure: the right "
+                                             "hand side is not finite at depth "
+                                             + std::to_string(x));
+                h = std::max(hMin, 0.2*h);
+                continue;
+            }
 
-            const double k1 = f_[i];
-            const double k2 = f(x + h2, y + h2*k1);
-            const double k3 = f(x + h2, y + h2*k2);
-            const double k4 = f(x + h, y + h*k3);
+            // accept the step if the error is small enough. if the step size cannot
+            // be reduced any further, e.g. due to a kink in the right hand side, the
+            // step is accepted regardless.
+            if (err <= 1.0 || h <= hMin) {
+                const double ydiff = yNew - y;
+                const double bspl = hs*k1 - ydiff;
+                coeffs_.push_back({{ y,
+                                     ydiff,
+                                     bspl,
+                                     ydiff - hs*k7 - bspl,
+                                     hs*(d1*k1 + d3*k3 + d4*k4 + d5*k5 + d6*k6 + d7*k7) }});
+
+                t += h;
+                t_.push_back(t);
+                y = yNew;
+                k1 = k7;
+            }
 
-            y_.push_back(y + h6*(k1 + 2*(k2 + k3) + k4));
-            f_.push_back(f(x + h, y_.back()));
+            const double fac = (err > 0.0) ? 0.9*std::pow(err, -1.0/5) : 5.0;
+            h = std::max(hMin, h*std::min(5.0, std::max(0.2, fac)));
         }
-
-        assert (y_.size() == std::vector<double>::size_type(N + 1));
     }
 
     double
     operator()(const double x) const
     {
-        // Dense output (O(h**3)) according to Shampine
-        // (Hermite interpolation)
-        const double h = stepsize();
-        int i = (x - span_[0]) / h;
-        const double t = (x - (span_[0] + i*h)) / h;
-
-        // Crude handling of evaluation point outside "span_";
-        if (i  <  0) { i = 0;      }
-        if (N_ <= i) { i = N_ - 1; }
+        if (coeffs_.empty()) {
+            return y0_;
+        }
 
-        const double y0 = y_[i], y1 = y_[i + 1];
-        const double f0 = f_[i], f1 = f_[i + 1];
+        // find the step which contains the evaluation point. points outside of the
+        // span are crudely handled by extrapolating the first or the last step.
+        const double t = dir_*(x - x0_);
+        const auto it = std::upper_bound(t_.begin() + 1, t_.end() - 1, t);
+        const std::size_t i = std::distance(t_.begin(), it) - 1;
 
-        double u = (1 - 2*t) * (y1 - y0);
-        u += h * ((t - 1)*f0 + t*f1);
-        u *= t * (t - 1);
-        u += (1 - t)*y0 + t*y1;
+        const double theta = (t - t_[i])/(t_[i + 1] - t_[i]);
+        const double theta1 = 1 - theta;
+        const auto& c = coeffs_[i];
 
-        return u;
+        return c[0] + theta*(c[1] + theta1*(c[2] + theta*(c[3] + theta1*c[4])));
     }
 
 private:
-    int N_;
-    std::array<double,2> span_;
-    std::vector<double>  y_;
-    std::vector<double>  f_;
+    double x0_;
+    double dir_;
+    double y0_;
 
-    double
-    stepsize() const { return (span_[1] - span_[0]) / N_; }
+    // distance of the accepted steps from the start of the span
+    std::vector<double> t_;
+
+    // coefficients of the continuous extension for each step
+    std::vector< std::array<double,5> > coeffs_;
 };
 
 namespace PhasePressODE {
@@ -281,41 +356,31 @@ private:
 
 
 namespace PhasePressure {
-template <class Grid,
-          class PressFunction,
-          class CellRange>
-void assign(const Grid& grid,
-            const std::array<PressFunction, 2>& f    ,
-            const double split,
-            const CellRange& cells,
-            std::vector<double>& p)
-{
+/**
+ * The pressure of a single fluid phase as a function of depth.
+ *
+ * This is computed once for each equilibration region and then evaluated for all of
+ * its cells. An empty table denotes an inactive phase.
+ */
+typedef std::function<double(double)> Table;
 
+template <class PressFunction>
+Table makeTable(const std::array<PressFunction, 2>& f,
+                const double split)
+{
     enum { up = 0, down = 1 };
 
-    std::vector<double>::size_type c = 0;
-    for (typename CellRange::const_iterator
-             ci = cells.begin(), ce = cells.end();
-         ci != ce; ++ci, ++c)
-    {
-        assert (c < p.size());
-
-        const double z = Opm::UgGridHelpers::cellCenterDepth(grid, *ci);
-        p[c] = (z < split) ? f[up](z) : f[down](z);
-    }
+    return [f, split](const double z) -> double
+    { return (z < split) ? f[up](z) : f[down](z); };
 }
 
 template <class FluidSystem,
-          class Grid,
-          class Region,
-          class CellRange>
-void water(const Grid& grid,
-           const Region& reg,
+          class Region>
+void water(const Region& reg,
            const std::array<double,2>& span  ,
            const double grav,
            double& poWoc,
-           const CellRange& cells,
-           std::vector<double>& press)
+           Table& table)
 {
     using PhasePressODE::Water;
     typedef Water<FluidSystem> ODE;
@@ -337,16 +402,16 @@ void water(const Grid& grid,
     std::array<double,2> up = {{ z0, span[0] }};
     std::array<double,2> down = {{ z0, span[1] }};
 
-    typedef Details::RK4IVP<ODE> WPress;
+    typedef Details::AdaptiveRKIVP<ODE> WPress;
     std::array<WPress,2> wpress = {
         {
-            WPress(drho, up  , p0, 2000)
+            WPress(drho, up  , p0)
             ,
-            WPress(drho, down, p0, 2000)
+            WPress(drho, down, p0)
         }
     };
 
-    assign(grid, wpress, z0, cells, press);
+    table = makeTable(wpress, z0);
 
     if (reg.datum() > reg.zwoc()) {
         // Return oil pressure at contact
@@ -355,15 +420,11 @@ void water(const Grid& grid,
 }
 
 template <class FluidSystem,
-          class Grid,
-          class Region,
-          class CellRange>
-void oil(const Grid& grid,
-         const Region& reg,
+          class Region>
+void oil(const Region& reg,
          const std::array<double,2>& span  ,
          const double grav,
-         const CellRange& cells,
-         std::vector<double>& press,
+         Table& table,
          double& poWoc,
          double& poGoc)
 {
@@ -392,16 +453,16 @@ void oil(const Grid& grid,
     std::array<double,2> up = {{ z0, span[0] }};
     std::array<double,2> down = {{ z0, span[1] }};
 
-    typedef Details::RK4IVP<ODE> OPress;
+    typedef Details::AdaptiveRKIVP<ODE> OPress;
     std::array<OPress,2> opress = {
         {
-            OPress(drho, up  , p0, 2000)
+            OPress(drho, up  , p0)
             ,
-            OPress(drho, down, p0, 2000)
+            OPress(drho, down, p0)
         }
     };
 
-    assign(grid, opress, z0, cells, press);
+    table = makeTable(opress, z0);
 
     const double woc = reg.zwoc();
     if      (z0 > woc) { poWoc = opress[0](woc); } // WOC above datum
@@ -415,16 +476,12 @@ void oil(const Grid& grid,
 }
 
 template <class FluidSystem,
-          class Grid,
-          class Region,
-          class CellRange>
-void gas(const Grid& grid,
-         const Region& reg,
+          class Region>
+void gas(const Region& reg,
          const std::array<double,2>& span  ,
          const double grav,
          double& poGoc,
-         const CellRange& cells,
-         std::vector<double>& press)
+         Table& table)
 {
     using PhasePressODE::Gas;
     typedef Gas<FluidSystem, typename Region::CalcEvaporation> ODE;
@@ -447,16 +504,16 @@ void gas(const Grid& grid,
     std::array<double,2> up = {{ z0, span[0] }};
     std::array<double,2> down = {{ z0, span[1] }};
 
-    typedef Details::RK4IVP<ODE> GPress;
+    typedef Details::AdaptiveRKIVP<ODE> GPress;
     std::array<GPress,2> gpress = {
         {
-            GPress(drho, up  , p0, 2000)
+            GPress(drho, up  , p0)
             ,
-            GPress(drho, down, p0, 2000)
+            GPress(drho, down, p0)
         }
     };
 
-    assign(grid, gpress, z0, cells, press);
+    table = makeTable(gpress, z0);
 
     if (reg.datum() < reg.zgoc()) {
         // Return oil pressure at contact
@@ -466,15 +523,11 @@ void gas(const Grid& grid,
 } // namespace PhasePressure
 
 template <class FluidSystem,
-          class Grid,
-          class Region,
-          class CellRange>
-void equilibrateOWG(const Grid& grid,
-                    const Region& reg,
+          class Region>
+void equilibrateOWG(const Region& reg,
                     const double grav,
                     const std::array<double,2>& span,
-                    const CellRange& cells,
-                    std::vector< std::vector<double> >& press)
+                    std::vector<PhasePressure::Table>& tables)
 {
     const bool water = FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx);
     const bool oil = FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx);
@@ -488,18 +541,18 @@ void equilibrateOWG(const Grid& grid,
         double poGoc = -1;
 
         if (water) {
-            PhasePressure::water<FluidSystem>(grid, reg, span, grav, poWoc,
-                                              cells, press[waterpos]);
+            PhasePressure::water<FluidSystem>(reg, span, grav, poWoc,
+                                              tables[waterpos]);
         }
 
         if (oil) {
-            PhasePressure::oil<FluidSystem>(grid, reg, span, grav, cells,
-                                            press[oilpos], poWoc, poGoc);
+            PhasePressure::oil<FluidSystem>(reg, span, grav,
+                                            tables[oilpos], poWoc, poGoc);
         }
 
         if (gas) {
-            PhasePressure::gas<FluidSystem>(grid, reg, span, grav, poGoc,
-                                            cells, press[gaspos]);
+            PhasePressure::gas<FluidSystem>(reg, span, grav, poGoc,
+                                            tables[gaspos]);
         }
     }
     else if (reg.datum() < reg.zgoc()) { // Datum in gas zone
@@ -507,18 +560,18 @@ void equilibrateOWG(const Grid& grid,
         double poGoc = -1;
 
         if (gas) {
-            PhasePressure::gas<FluidSystem>(grid, reg, span, grav, poGoc,
-                                            cells, press[gaspos]);
+            PhasePressure::gas<FluidSystem>(reg, span, grav, poGoc,
+                                            tables[gaspos]);
         }
 
         if (oil) {
-            PhasePressure::oil<FluidSystem>(grid, reg, span, grav, cells,
-                                            press[oilpos], poWoc, poGoc);
+            PhasePressure::oil<FluidSystem>(reg, span, grav,
+                                            tables[oilpos], poWoc, poGoc);
         }
 
         if (water) {
-            PhasePressure::water<FluidSystem>(grid, reg, span, grav, poWoc,
-                                              cells, press[waterpos]);
+            PhasePressure::water<FluidSystem>(reg, span, grav, poWoc,
+                                              tables[waterpos]);
         }
     }
     else { // Datum in oil zone
@@ -526,73 +579,36 @@ void equilibrateOWG(const Grid& grid,
         double poGoc = -1;
 
         if (oil) {
-            PhasePressure::oil<FluidSystem>(grid, reg, span, grav, cells,
-                                            press[oilpos], poWoc, poGoc);
+            PhasePressure::oil<FluidSystem>(reg, span, grav,
+                                            tables[oilpos], poWoc, poGoc);
         }
 
         if (water) {
-            PhasePressure::water<FluidSystem>(grid, reg, span, grav, poWoc,
-                                              cells, press[waterpos]);
+            PhasePressure::water<FluidSystem>(reg, span, grav, poWoc,
+                                              tables[waterpos]);
         }
 
         if (gas) {
-            PhasePressure::gas<FluidSystem>(grid, reg, span, grav, poGoc,
-                                            cells, press[gaspos]);
+            PhasePressure::gas<FluidSystem>(reg, span, grav, poGoc,
+                                            tables[gaspos]);
         }
     }
 }
 } // namespace Details
 
+namespace Details {
 /**
- * Compute initial phase pressures by means of equilibration.
- *
- * This function uses the information contained in an
- * equilibration record (i.e., depths and pressurs) as well as
- * a density calculator and related data to vertically
- * integrate the phase pressure ODE
- * \f[
- * \frac{\mathrm{d}p_{\alpha}}{\mathrm{d}z} =
- * \rho_{\alpha}(z,p_{\alpha})\cdot g
- * \f]
- * in which \f$\rho_{\alpha}$ denotes the fluid density of
- * fluid phase \f$\alpha\f$, \f$p_{\alpha}\f$ is the
- * corresponding phase pressure, \f$z\f$ is the depth and
- * \f$g\f$ is the acceleration due to gravity (assumed
- * directed downwords, in the positive \f$z\f$ direction).
- *
- * \tparam Region Type of an equilibration region information
- *                base.  Typically an instance of the EquilReg
- *                class template.
- *
- * \tparam CellRange Type of cell range that demarcates the
- *                cells pertaining to the current
- *                equilibration region.  Must implement
- *                methods begin() and end() to bound the range
- *                as well as provide an inner type,
- *                const_iterator, to traverse the range.
- *
- * \param[in] grid     Grid.
- * \param[in] reg   Current equilibration region.
- * \param[in] cells Range that spans the cells of the current
- *                  equilibration region.
- * \param[in] grav  Acceleration of gravity.
- *
- * \return Phase pressures, one vector for each active phase,
- * of pressure values in each cell in the current
- * equilibration region.
+ * Compute the vertical span of a range of cells, i.e., the minimum
+ * and maximum depths of their vertices.
  */
-template <class FluidSystem, class Grid, class Region, class CellRange>
-std::vector< std::vector<double>>
-phasePressures(const Grid& grid,
-               const Region& reg,
-               const CellRange& cells,
-               const double grav = Opm::unit::gravity)
+template <class Grid, class CellRange>
+std::array<double,2> verticalSpan(const Grid& grid,
+                                  const CellRange& cells)
 {
     std::array<double,2> span =
         {{  std::numeric_limits<double>::max(),
             -std::numeric_limits<double>::max() }}; // Symm. about 0.
 
-    int ncell = 0;
     {
         // This code is only supported in three space dimensions
         assert (Grid::dimensionworld == 3);
@@ -608,7 +624,7 @@ phasePressures(const Grid& grid,
         // compute those bounds.  This necessarily entails
         // visiting some nodes (and faces) multiple times.
         //
-        // Note: The implementation of 'RK4IVP<>' implicitly
+        // Note: The implementation of 'AdaptiveRKIVP<>' implicitly
         // imposes the requirement that cell centroids are all
         // within this vertical span.  That requirement is not
         // checked.
@@ -617,7 +633,7 @@ phasePressures(const Grid& grid,
 
         for (typename CellRange::const_iterator
                  ci = cells.begin(), ce = cells.end();
-             ci != ce; ++ci, ++ncell)
+             ci != ce; ++ci)
         {
             for (auto fi=cell2Faces[*ci].begin(),
                      fe=cell2Faces[*ci].end();
@@ -635,10 +651,23 @@ phasePressures(const Grid& grid,
             }
         }
     }
+
+    return span;
+}
+
+/**
+ * Compute the pressure-vs-depth tables of all phases for a given
+ * vertical span.
+ */
+template <class FluidSystem, class Region>
+std::vector<PhasePressure::Table>
+phasePressureTables(const Region& reg,
+                    std::array<double,2> span,
+                    const double grav)
+{
     const int np = FluidSystem::numPhases;  //reg.phaseUsage().numPhases;
 
-    typedef std::vector<double> pval;
-    std::vector<pval> press(np, pval(ncell, 0.0));
+    std::vector<PhasePressure::Table> tables(np);
 
     const double zwoc = reg.zwoc ();
     const double zgoc = reg.zgoc ();
@@ -647,18 +676,66 @@ phasePressures(const Grid& grid,
     span[0] = std::min(span[0],zgoc);
     span[1] = std::max(span[1],zwoc);
 
-    Details::equilibrateOWG<FluidSystem>(grid, reg, grav, span, cells, press);
+    equilibrateOWG<FluidSystem>(reg, grav, span, tables);
 
-    return press;
+    return tables;
 }
+} // namespace Details
 
 /**
- * Compute initial phase saturations by means of equilibration.
+ * Compute the pressure-vs-depth tables of all phases by means of equilibration.
  *
- * \tparam FluidSystem  The FluidSystem from opm-material
- *                      Must be initialized before used.
+ * This function uses the information contained in an
+ * equilibration record (i.e., depths and pressurs) as well as
+ * a density calculator and related data to vertically
+ * integrate the phase pressure ODE
+ * \f[
+ * \frac{\mathrm{d}p_{\alpha}}{\mathrm{d}z} =
+ * \rho_{\alpha}(z,p_{\alpha})\cdot g
+ * \f]
+ * in which \f$\rho_{\alpha}$ denotes the fluid density of
+ * fluid phase \f$\alpha\f$, \f$p_{\alpha}\f$ is the
+ * corresponding phase pressure, \f$z\f$ is the depth and
+ * \f$g\f$ is the acceleration due to gravity (assumed
+ * directed downwords, in the positive \f$z\f$ direction).
  *
- * \tparam Grid   Type of the grid
+ * \tparam Region Type of an equilibration region information
+ *                base.  Typically an instance of the EquilReg
+ *                class template.
+ *
+ * \tparam CellRange Type of cell range that demarcates the
+ *                cells pertaining to the current
+ *                equilibration region.  Must implement
+ *                methods begin() and end() to bound the range
+ *                as well as provide an inner type,
+ *                const_iterator, to traverse the range.
+ *
+ * \param[in] grid     Grid.
+ * \param[in] reg   Current equilibration region.
+ * \param[in] cells Range that spans the cells of the current
+ *                  equilibration region.
+ * \param[in] grav  Acceleration of gravity.
+ *
+ * \return Phase pressures as a function of depth, one table for each
+ * phase. The tables of inactive phases are empty.
+ */
+template <class FluidSystem, class Grid, class Region, class CellRange>
+std::vector<Details::PhasePressure::Table>
+phasePressureTables(const Grid& grid,
+                    const Region& reg,
+                    const CellRange& cells,
+                    const double grav = Opm::unit::gravity)
+{
+    return Details::phasePressureTables<FluidSystem>(reg,
+                                                     Details::verticalSpan(grid, cells),
+                                                     grav);
+}
+
+/**
+ * Compute initial phase pressures by means of equilibration.
+ *
+ * This evaluates the tables computed by phasePressureTables() at
+ * the centers of the cells of the equilibration region.
  *
  * \tparam Region Type of an equilibration region information
  *                base.  Typically an instance of the EquilReg
@@ -671,36 +748,67 @@ phasePressures(const Grid& grid,
  *                as well as provide an inner type,
  *                const_iterator, to traverse the range.
  *
- * \tparam MaterialLawManager The MaterialLawManager from opm-material
+ * \param[in] grid     Grid.
+ * \param[in] reg   Current equilibration region.
+ * \param[in] cells Range that spans the cells of the current
+ *                  equilibration region.
+ * \param[in] grav  Acceleration of gravity.
  *
- * \param[in] grid               Grid.
- * \param[in] reg             Current equilibration region.
- * \param[in] cells           Range that spans the cells of the current
- *                            equilibration region.
- * \param[in] materialLawManager   The MaterialLawManager from opm-material
- * \param[in] swatInit       A vector of initial water saturations.
- *                            The capillary pressure is scaled to fit these values
- * \param[in] phasePressures Phase pressures, one vector for each active phase,
- *                            of pressure values in each cell in the current
- *                            equilibration region.
- * \return                    Phase saturations, one vector for each phase, each containing
- *                            one saturation value per cell in the region.
+ * \return Phase pressures, one vector for each active phase,
+ * of pressure values in each cell in the current
+ * equilibration region.
  */
-template <class FluidSystem, class Grid, class Region, class CellRange, class MaterialLawManager>
+template <class FluidSystem, class Grid, class Region, class CellRange>
 std::vector< std::vector<double>>
-phaseSaturations(const Grid& grid,
-                 const Region& reg,
-                 const CellRange& cells,
-                 MaterialLawManager& materialLawManager,
-                 const std::vector<double> swatInit,
-                 std::vector< std::vector<double> >& phasePressures)
+phasePressures(const Grid& grid,
+               const Region& reg,
+               const CellRange& cells,
+               const double grav = Opm::unit::gravity)
+{
+    const auto tables = phasePressureTables<FluidSystem>(grid, reg, cells, grav);
+
+    const int np = FluidSystem::numPhases;
+    const auto ncell = std::distance(cells.begin(), cells.end());
+    typedef std::vector<double> pval;
+    std::vector<pval> press(np, pval(ncell, 0.0));
+
+    std::vector<double>::size_type c = 0;
+    for (typename CellRange::const_iterator
+             ci = cells.begin(), ce = cells.end();
+         ci != ce; ++ci, ++c)
+    {
+        const double z = Opm::UgGridHelpers::cellCenterDepth(grid, *ci);
+        for (int p = 0; p < np; ++p) {
+            if (tables[p])
+                press[p][c] = tables[p](z);
+        }
+    }
+
+    return press;
+}
+
+namespace Details {
+/**
+ * Compute the initial phase saturations of a single cell by means of equilibration.
+ *
+ * The phase pressures are adjusted for the minimum and maximum saturations of the
+ * cell. All quantities are indexed by the fluid system's phase index. The saturation
+ * of inactive phases is set to their pressure value for consistency with
+ * phaseSaturations().
+ */
+template <class FluidSystem, class Grid, class Region, class MaterialLawManager>
+void cellPhaseSaturations(const Grid& grid,
+                          const Region& reg,
+                          const int cell,
+                          MaterialLawManager& materialLawManager,
+                          const std::vector<double>& swatInit,
+                          double* press,
+                          double* sat)
 {
     if (!FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx)) {
         throw std::runtime_error("Cannot initialise: not handling water-gas cases.");
     }
 
-    std::vector< std::vector<double> > phaseSaturations = phasePressures; // Just to get the right size.
-
     // Adjust oil pressure according to gas saturation and cap pressure
     typedef Opm::SimpleModularFluidState<double,
                                          /*numPhases=*/3,
@@ -716,6 +824,8 @@ phaseSaturations(const Grid& grid,
                                          /*storeEnthalpy=*/false> SatOnlyFluidState;
 
     SatOnlyFluidState fluidState;
+    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
+        fluidState.setSaturation(phaseIdx, 0.0);
     typedef typename MaterialLawManager::MaterialLaw MaterialLaw;
 
     const bool water = FluidSystem::phaseIsActive(FluidSystem::waterPhaseIdx);
@@ -723,124 +833,188 @@ phaseSaturations(const Grid& grid,
     const int oilpos = FluidSystem::oilPhaseIdx;
     const int waterpos = FluidSystem::waterPhaseIdx;
     const int gaspos = FluidSystem::gasPhaseIdx;
-    std::vector<double>::size_type localIndex = 0;
-    for (typename CellRange::const_iterator ci = cells.begin(); ci != cells.end(); ++ci, ++localIndex) {
-        const int cell = *ci;
-        const auto& scaledDrainageInfo =
-            materialLawManager.oilWaterScaledEpsInfoDrainage(cell);
-        const auto& matParams = materialLawManager.materialLawParams(cell);
-
-        // Find saturations from pressure differences by
-        // inverting capillary pressure functions.
-        double sw = 0.0;
-        if (water) {
-            if (isConstPc<FluidSystem, MaterialLaw, MaterialLawManager>(materialLawManager,FluidSystem::waterPhaseIdx, cell)){
-                const double cellDepth = Opm::UgGridHelpers::cellCenterDepth(grid,
-                                                                             cell);
-                sw = satFromDepth<FluidSystem, MaterialLaw, MaterialLawManager>(materialLawManager,cellDepth,reg.zwoc(),waterpos,cell,false);
-                phaseSaturations[waterpos][localIndex] = sw;
-            }
-            else {
-                const double pcov = phasePressures[oilpos][localIndex] - phasePressures[waterpos][localIndex];
-                if (swatInit.empty()) { // Invert Pc to find sw
-                    sw = satFromPc<FluidSystem, MaterialLaw, MaterialLawManager>(materialLawManager, waterpos, cell, pcov);
-                    phaseSaturations[waterpos][localIndex] = sw;
-                }
-                else { // Scale Pc to reflect imposed sw
-                    sw = swatInit[cell];
-                    sw = materialLawManager.applySwatinit(cell, pcov, sw);
-                    phaseSaturations[waterpos][localIndex] = sw;
-                }
-            }
-        }
-        double sg = 0.0;
-        if (gas) {
-            if (isConstPc<FluidSystem, MaterialLaw, MaterialLawManager>(materialLawManager,FluidSystem::gasPhaseIdx,cell)){
-                const double cellDepth = Opm::UgGridHelpers::cellCenterDepth(grid,
-                                                                             cell);
-                sg = satFromDepth<FluidSystem, MaterialLaw, MaterialLawManager>(materialLawManager,cellDepth,reg.zgoc(),gaspos,cell,true);
-                phaseSaturations[gaspos][localIndex] = sg;
-            }
-            else {
-                // Note that pcog is defined to be (pg - po), not (po - pg).
-                const double pcog = phasePressures[gaspos][localIndex] - phasePressures[oilpos][localIndex];
-                const double increasing = true; // pcog(sg) expected to be increasing function
-                sg = satFromPc<FluidSystem, MaterialLaw, MaterialLawManager>(materialLawManager, gaspos, cell, pcog, increasing);
-                phaseSaturations[gaspos][localIndex] = sg;
-            }
+
+    for (unsigned phaseIdx = 0; phaseIdx < FluidSystem::numPhases; ++phaseIdx)
+        sat[phaseIdx] = press[phaseIdx];
+
+    const auto& scaledDrainageInfo =
+        materialLawManager.oilWaterScaledEpsInfoDrainage(cell);
+    const auto& matParams = materialLawManager.materialLawParams(cell);
+
+    // Find saturations from pressure differences by
+    // inverting capillary pressure functions.
+    double sw = 0.0;
+    if (water) {
+        if (isConstPc<FluidSystem, MaterialLaw, MaterialLawManager>(materialLawManager,FluidSystem::waterPhaseIdx, cell)){
+            const double cellDepth = Opm::UgGridHelpers::cellCenterDepth(grid,
+                                                                         cell);
+            sw = satFromDepth<FluidSystem, MaterialLaw, MaterialLawManager>(materialLawManager,cellDepth,reg.zwoc(),waterpos,cell,false);
+            sat[waterpos] = sw;
         }
-        if (gas && water && (sg + sw > 1.0)) {
-            // Overlapping gas-oil and oil-water transition
-            // zones can lead to unphysical saturations when
-            // treated as above. Must recalculate using gas-water
-            // capillary pressure.
-            const double pcgw = phasePressures[gaspos][localIndex] - phasePressures[waterpos][localIndex];
-            if (! swatInit.empty()) {
-                // Re-scale Pc to reflect imposed sw for vanishing oil phase.
-                // This seems consistent with ecl, and fails to honour
-                // swatInit in case of non-trivial gas-oil cap pressure.
-                sw = materialLawManager.applySwatinit(cell, pcgw, sw);
+        else {
+            const double pcov = press[oilpos] - press[waterpos];
+            if (swatInit.empty()) { // Invert Pc to find sw
+                sw = satFromPc<FluidSystem, MaterialLaw, MaterialLawManager>(materialLawManager, waterpos, cell, pcov);
+                sat[waterpos] = sw;
             }
-            sw = satFromSumOfPcs<FluidSystem, MaterialLaw, MaterialLawManager>(materialLawManager, waterpos, gaspos, cell, pcgw);
-            sg = 1.0 - sw;
-            phaseSaturations[waterpos][localIndex] = sw;
-            phaseSaturations[gaspos][localIndex] = sg;
-            if (water) {
-                fluidState.setSaturation(FluidSystem::waterPhaseIdx, sw);
+            else { // Scale Pc to reflect imposed sw
+                sw = swatInit[cell];
+                sw = materialLawManager.applySwatinit(cell, pcov, sw);
+                sat[waterpos] = sw;
             }
-            else {
-                fluidState.setSaturation(FluidSystem::waterPhaseIdx, 0.0);
-            }
-            fluidState.setSaturation(FluidSystem::oilPhaseIdx, 1.0 - sw - sg);
-            fluidState.setSaturation(FluidSystem::gasPhaseIdx, sg);
-
-            double pC[/*numPhases=*/3] = { 0.0, 0.0, 0.0 };
-            MaterialLaw::capillaryPressures(pC, matParams, fluidState);
-            double pcGas = pC[FluidSystem::oilPhaseIdx] + pC[FluidSystem::gasPhaseIdx];
-            phasePressures[oilpos][localIndex] = phasePressures[gaspos][localIndex] - pcGas;
         }
-        phaseSaturations[oilpos][localIndex] = 1.0 - sw - sg;
-
-        // Adjust phase pressures for max and min saturation ...
-        double thresholdSat = 1.0e-6;
-
-        double so = 1.0;
-        double pC[FluidSystem::numPhases] = { 0.0, 0.0, 0.0 };
-        if (water) {
-            double swu = scaledDrainageInfo.Swu;
-            fluidState.setSaturation(FluidSystem::waterPhaseIdx, swu);
-            so -= swu;
+    }
+    double sg = 0.0;
+    if (gas) {
+        if (isConstPc<FluidSystem, MaterialLaw, MaterialLawManager>(materialLawManager,FluidSystem::gasPhaseIdx,cell)){
+            const double cellDepth = Opm::UgGridHelpers::cellCenterDepth(grid,
+                                                                         cell);
+            sg = satFromDepth<FluidSystem, MaterialLaw, MaterialLawManager>(materialLawManager,cellDepth,reg.zgoc(),gaspos,cell,true);
+            sat[gaspos] = sg;
         }
-        if (gas) {
-            double sgu = scaledDrainageInfo.Sgu;
-            fluidState.setSaturation(FluidSystem::gasPhaseIdx, sgu);
-            so-= sgu;
+        else {
+            // Note that pcog is defined to be (pg - po), not (po - pg).
+            const double pcog = press[gaspos] - press[oilpos];
+            const double increasing = true; // pcog(sg) expected to be increasing function
+            sg = satFromPc<FluidSystem, MaterialLaw, MaterialLawManager>(materialLawManager, gaspos, cell, pcog, increasing);
+            sat[gaspos] = sg;
         }
-        fluidState.setSaturation(FluidSystem::oilPhaseIdx, so);
-
-        if (water && sw > scaledDrainageInfo.Swu-thresholdSat) {
-            fluidState.setSaturation(FluidSystem::waterPhaseIdx, scaledDrainageInfo.Swu);
-            MaterialLaw::capillaryPressures(pC, matParams, fluidState);
-            double pcWat = pC[FluidSystem::oilPhaseIdx] - pC[FluidSystem::waterPhaseIdx];
-            phasePressures[oilpos][localIndex] = phasePressures[waterpos][localIndex] + pcWat;
+    }
+    if (gas && water && (sg + sw > 1.0)) {
+        // Overlapping gas-oil and oil-water transition
+        // zones can lead to unphysical saturations when
+        // treated as above. Must recalculate using gas-water
+        // capillary pressure.
+        const double pcgw = press[gaspos] - press[waterpos];
+        if (! swatInit.empty()) {
+            // Re-scale Pc to reflect imposed sw for vanishing oil phase.
+            // This seems consistent with ecl, and fails to honour
+            // swatInit in case of non-trivial gas-oil cap pressure.
+            sw = materialLawManager.applySwatinit(cell, pcgw, sw);
         }
-        else if (gas && sg > scaledDrainageInfo.Sgu-thresholdSat) {
-            fluidState.setSaturation(FluidSystem::gasPhaseIdx, scaledDrainageInfo.Sgu);
-            MaterialLaw::capillaryPressures(pC, matParams, fluidState);
-            double pcGas = pC[FluidSystem::oilPhaseIdx] + pC[FluidSystem::gasPhaseIdx];
-            phasePressures[oilpos][localIndex] = phasePressures[gaspos][localIndex] - pcGas;
+        sw = satFromSumOfPcs<FluidSystem, MaterialLaw, MaterialLawManager>(materialLawManager, waterpos, gaspos, cell, pcgw);
+        sg = 1.0 - sw;
+        sat[waterpos] = sw;
+        sat[gaspos] = sg;
+        if (water) {
+            fluidState.setSaturation(FluidSystem::waterPhaseIdx, sw);
         }
-        if (gas && sg < scaledDrainageInfo.Sgl+thresholdSat) {
-            fluidState.setSaturation(FluidSystem::gasPhaseIdx, scaledDrainageInfo.Sgl);
-            MaterialLaw::capillaryPressures(pC, matParams, fluidState);
-            double pcGas = pC[FluidSystem::oilPhaseIdx] + pC[FluidSystem::gasPhaseIdx];
-            phasePressures[gaspos][localIndex] = phasePressures[oilpos][localIndex] + pcGas;
+        else {
+            fluidState.setSaturation(FluidSystem::waterPhaseIdx, 0.0);
         }
-        if (water && sw < scaledDrainageInfo.Swl+thresholdSat) {
-            fluidState.setSaturation(FluidSystem::waterPhaseIdx, scaledDrainageInfo.Swl);
-            MaterialLaw::capillaryPressures(pC, matParams, fluidState);
-            double pcWat = pC[FluidSystem::oilPhaseIdx] - pC[FluidSystem::waterPhaseIdx];
-            phasePressures[waterpos][localIndex] = phasePressures[oilpos][localIndex] - pcWat;
+        fluidState.setSaturation(FluidSystem::oilPhaseIdx, 1.0 - sw - sg);
+        fluidState.setSaturation(FluidSystem::gasPhaseIdx, sg);
+
+        double pC[/*numPhases=*/3] = { 0.0, 0.0, 0.0 };
+        MaterialLaw::capillaryPressures(pC, matParams, fluidState);
+        double pcGas = pC[FluidSystem::oilPhaseIdx] + pC[FluidSystem::gasPhaseIdx];
+        press[oilpos] = press[gaspos] - pcGas;
+    }
+    sat[oilpos] = 1.0 - sw - sg;
+
+    // Adjust phase pressures for max and min saturation ...
+    double thresholdSat = 1.0e-6;
+
+    double so = 1.0;
+    double pC[FluidSystem::numPhases] = { 0.0, 0.0, 0.0 };
+    if (water) {
+        double swu = scaledDrainageInfo.Swu;
+        fluidState.setSaturation(FluidSystem::waterPhaseIdx, swu);
+        so -= swu;
+    }
+    if (gas) {
+        double sgu = scaledDrainageInfo.Sgu;
+        fluidState.setSaturation(FluidSystem::gasPhaseIdx, sgu);
+        so-= sgu;
+    }
+    fluidState.setSaturation(FluidSystem::oilPhaseIdx, so);
+
+    if (water && sw > scaledDrainageInfo.Swu-thresholdSat) {
+        fluidState.setSaturation(FluidSystem::waterPhaseIdx, scaledDrainageInfo.Swu);
+        MaterialLaw::capillaryPressures(pC, matParams, fluidState);
+        double pcWat = pC[FluidSystem::oilPhaseIdx] - pC[FluidSystem::waterPhaseIdx];
+        press[oilpos] = press[waterpos] + pcWat;
+    }
+    else if (gas && sg > scaledDrainageInfo.Sgu-thresholdSat) {
+        fluidState.setSaturation(FluidSystem::gasPhaseIdx, scaledDrainageInfo.Sgu);
+        MaterialLaw::capillaryPressures(pC, matParams, fluidState);
+        double pcGas = pC[FluidSystem::oilPhaseIdx] + pC[FluidSystem::gasPhaseIdx];
+        press[oilpos] = press[gaspos] - pcGas;
+    }
+    if (gas && sg < scaledDrainageInfo.Sgl+thresholdSat) {
+        fluidState.setSaturation(FluidSystem::gasPhaseIdx, scaledDrainageInfo.Sgl);
+        MaterialLaw::capillaryPressures(pC, matParams, fluidState);
+        double pcGas = pC[FluidSystem::oilPhaseIdx] + pC[FluidSystem::gasPhaseIdx];
+        press[gaspos] = press[oilpos] + pcGas;
+    }
+    if (water && sw < scaledDrainageInfo.Swl+thresholdSat) {
+        fluidState.setSaturation(FluidSystem::waterPhaseIdx, scaledDrainageInfo.Swl);
+        MaterialLaw::capillaryPressures(pC, matParams, fluidState);
+        double pcWat = pC[FluidSystem::oilPhaseIdx] - pC[FluidSystem::waterPhaseIdx];
+        press[waterpos] = press[oilpos] - pcWat;
+    }
+}
+} // namespace Details
+
+/**
+ * Compute initial phase saturations by means of equilibration.
+ *
+ * \tparam FluidSystem  The FluidSystem from opm-material
+ *                      Must be initialized before used.
+ *
+ * \tparam Grid   Type of the grid
+ *
+ * \tparam Region Type of an equilibration region information
+ *                base.  Typically an instance of the EquilReg
+ *                class template.
+ *
+ * \tparam CellRange Type of cell range that demarcates the
+ *                cells pertaining to the current
+ *                equilibration region.  Must implement
+ *                methods begin() and end() to bound the range
+ *                as well as provide an inner type,
+ *                const_iterator, to traverse the range.
+ *
+ * \tparam MaterialLawManager The MaterialLawManager from opm-material
+ *
+ * \param[in] grid               Grid.
+ * \param[in] reg             Current equilibration region.
+ * \param[in] cells           Range that spans the cells of the current
+ *                            equilibration region.
+ * \param[in] materialLawManager   The MaterialLawManager from opm-material
+ * \param[in] swatInit       A vector of initial water saturations.
+ *                            The capillary pressure is scaled to fit these values
+ * \param[in] phasePressures Phase pressures, one vector for each active phase,
+ *                            of pressure values in each cell in the current
+ *                            equilibration region.
+ * \return                    Phase saturations, one vector for each phase, each containing
+ *                            one saturation value per cell in the region.
+ */
+template <class FluidSystem, class Grid, class Region, class CellRange, class MaterialLawManager>
+std::vector< std::vector<double>>
+phaseSaturations(const Grid& grid,
+                 const Region& reg,
+                 const CellRange& cells,
+                 MaterialLawManager& materialLawManager,
+                 const std::vector<double>& swatInit,
+                 std::vector< std::vector<double> >& phasePressures)
+{
+    std::vector< std::vector<double> > phaseSaturations = phasePressures; // Just to get the right size.
+
+    const int np = FluidSystem::numPhases;
+    std::vector<double>::size_type localIndex = 0;
+    for (typename CellRange::const_iterator ci = cells.begin(); ci != cells.end(); ++ci, ++localIndex) {
+        double press[FluidSystem::numPhases];
+        double sat[FluidSystem::numPhases];
+        for (int p = 0; p < np; ++p)
+            press[p] = phasePressures[p][localIndex];
+
+        Details::cellPhaseSaturations<FluidSystem>(grid, reg, *ci, materialLawManager,
+                                                   swatInit, press, sat);
+
+        for (int p = 0; p < np; ++p) {
+            phasePressures[p][localIndex] = press[p];
+            phaseSaturations[p][localIndex] = sat[p];
         }
     }
     return phaseSaturations;
@@ -867,10 +1041,10 @@ phaseSaturations(const Grid& grid,
 template <class Grid, class CellRangeType>
 std::vector<double> computeRs(const Grid& grid,
                               const CellRangeType& cells,
-                              const std::vector<double> oilPressure,
+                              const std::vector<double>& oilPressure,
                               const std::vector<double>& temperature,
                               const Miscibility::RsFunction& rsFunc,
-                              const std::vector<double> gasSaturation)
+                              const std::vector<double>& gasSaturation)
 {
     assert(Grid::dimensionworld == 3);
     std::vector<double> rs(cells.size());
@@ -965,7 +1139,14 @@ public:
         regionPvtIdx_.resize(rec.size(), invalidRegion);
         setRegionPvtIdx(grid, eclipseState, eqlmap);
 
-        // Create Rs functions.
+        // Create Rs functions. The functions which do not depend on tables specified by
+        // the deck are shared by all regions which use the same parameters. This allows
+        // to share the pressure tables of equivalent regions.
+        typedef std::pair<int, double> ContactKey;
+        std::map<ContactKey, std::shared_ptr<Miscibility::RsFunction> > rsSatAtContact;
+        std::map<ContactKey, std::shared_ptr<Miscibility::RsFunction> > rvSatAtContact;
+        const auto noMixing = std::make_shared<Miscibility::NoMixing>();
+
         rsFunc_.reserve(rec.size());
         if (FluidSystem::enableDissolvedGas()) {
             for (size_t i = 0; i < rec.size(); ++i) {
@@ -1004,13 +1185,16 @@ public:
                     }
                     const double pContact = rec[i].datumDepthPressure();
                     const double TContact = 273.15 + 20; // standard temperature for now
-                    rsFunc_.push_back(std::make_shared<Miscibility::RsSatAtContact<FluidSystem>>(pvtIdx, pContact, TContact));
+                    auto& rsFunc = rsSatAtContact[ContactKey(pvtIdx, pContact)];
+                    if (!rsFunc)
+                        rsFunc = std::make_shared<Miscibility::RsSatAtContact<FluidSystem>>(pvtIdx, pContact, TContact);
+                    rsFunc_.push_back(rsFunc);
                 }
             }
         }
         else {
             for (size_t i = 0; i < rec.size(); ++i) {
-                rsFunc_.push_back(std::make_shared<Miscibility::NoMixing>());
+                rsFunc_.push_back(noMixing);
             }
         }
 
@@ -1051,13 +1235,16 @@ public:
                     }
                     const double pContact = rec[i].datumDepthPressure() + rec[i].gasOilContactCapillaryPressure();
                     const double TContact = 273.15 + 20; // standard temperature for now
-                    rvFunc_.push_back(std::make_shared<Miscibility::RvSatAtContact<FluidSystem>>(pvtIdx,pContact, TContact));
+                    auto& rvFunc = rvSatAtContact[ContactKey(pvtIdx, pContact)];
+                    if (!rvFunc)
+                        rvFunc = std::make_shared<Miscibility::RvSatAtContact<FluidSystem>>(pvtIdx, pContact, TContact);
+                    rvFunc_.push_back(rvFunc);
                 }
             }
         }
         else {
             for (size_t i = 0; i < rec.size(); ++i) {
-                rvFunc_.push_back(std::make_shared<Miscibility::NoMixing>());
+                rvFunc_.push_back(noMixing);
             }
         }
 
@@ -1136,50 +1323,184 @@ private:
                           const Grid& grid,
                           const double grav)
     {
+        typedef Details::PhasePressure::Table PressureTable;
+        const int np = FluidSystem::numPhases;
+
+        // the equilibration regions which need to be considered
+        std::vector<int> regions;
         for (const auto& r : reg.activeRegions()) {
-            const auto& cells = reg.cells(r);
-            if (cells.empty()) {
+            if (reg.cells(r).empty()) {
                 Opm::OpmLog::warning("Equilibration region " + std::to_string(r + 1)
                                      + " has no active cells");
                 continue;
             }
+            regions.push_back(r);
+        }
+
+        std::vector<EqReg> eqRegs;
+        eqRegs.reserve(rec.size());
+        for (size_t r = 0; r < rec.size(); ++r)
+            eqRegs.emplace_back(rec[r], rsFunc_[r], rvFunc_[r], regionPvtIdx_[r]);
+
+        int numRegions = static_cast<int>(regions.size());
+        std::vector<std::array<double,2> > spans(rec.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int i = 0; i < numRegions; ++i) {
+            const int r = regions[i];
+            spans[r] = Details::verticalSpan(grid, reg.cells(r));
+        }
+
+        // regions which exhibit the same equilibration data and PVT region use the same
+        // pressure-vs-depth tables. these are computed only once for the union of the
+        // vertical spans of all regions which use them.
+        typedef std::tuple<int, double, double, double, double, double, double,
+                           const Miscibility::RsFunction*,
+                           const Miscibility::RsFunction*> TableKey;
+        std::map<TableKey, unsigned> tableIndices;
+        std::vector<int> tableRegion;
+        std::vector<std::array<double,2> > tableSpans;
+        std::vector<unsigned> regionTableIdx(rec.size(), 0);
+        for (const int r : regions) {
+            const EqReg& eqReg = eqRegs[r];
+            const TableKey key(eqReg.pvtIdx(),
+                               eqReg.datum(),
+                               eqReg.pressure(),
+                               eqReg.zwoc(),
+                               eqReg.pcowWoc(),
+                               eqReg.zgoc(),
+                               eqReg.pcgoGoc(),
+                               rsFunc_[r].get(),
+                               rvFunc_[r].get());
+            const auto res = tableIndices.insert(std::make_pair(key, tableRegion.size()));
+            const unsigned tableIdx = res.first->second;
+            if (res.second) {
+                tableRegion.push_back(r);
+                tableSpans.push_back(spans[r]);
+            }
+            else {
+                auto& span = tableSpans[tableIdx];
+                span[0] = std::min(span[0], spans[r][0]);
+                span[1] = std::max(span[1], spans[r][1]);
+            }
+            regionTableIdx[r] = tableIdx;
+        }
 
-            const EqReg eqreg(rec[r], rsFunc_[r], rvFunc_[r], regionPvtIdx_[r]);
+        // compute the pressure-vs-depth tables. this integrates the phase pressure
+        // ODEs, so it is done exactly once per table and the result is shared by all
+        // cells which use it.
+        std::vector<std::vector<PressureTable> > pressTables(tableRegion.size());
+        std::exception_ptr exc;
+        int numTables = static_cast<int>(tableRegion.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+        for (int tableIdx = 0; tableIdx < numTables; ++tableIdx) {
+            try {
+                pressTables[tableIdx] =
+                    Details::phasePressureTables<FluidSystem>(eqRegs[tableRegion[tableIdx]],
+                                                              tableSpans[tableIdx],
+                                                              grav);
+            }
+            catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                if (!exc)
+                    exc = std::current_exception();
+            }
+        }
+        if (exc)
+            std::rethrow_exception(exc);
 
-            PVec pressures = phasePressures<FluidSystem>(grid, eqreg, cells, grav);
-            const PVec sat = phaseSaturations<FluidSystem>(grid, eqreg, cells, materialLawManager, swatInit_, pressures);
+        // flatten the cells of all regions into a single list of work items. the items
+        // are ordered by saturation region so that the cells which use the same
+        // saturation functions are processed consecutively.
+        struct CellInfo
+        {
+            int cellIdx;
+            int regionIdx;
+            int satnumIdx;
+        };
+        const std::vector<int> satnum = cellSatnumIdx_(grid, eclState);
+        std::vector<CellInfo> cellInfos;
+        for (const int r : regions)
+            for (const int cell : reg.cells(r))
+                cellInfos.push_back(CellInfo{cell, r, satnum[cell]});
+        std::stable_sort(cellInfos.begin(), cellInfos.end(),
+                         [](const CellInfo& a, const CellInfo& b)
+                         { return a.satnumIdx < b.satnumIdx; });
+
+        // compute the pressures, saturations, rs and rv factors of the cells. applying
+        // SWATINIT modifies the scaling of the material law parameters, so the cells
+        // are only processed in parallel if it is not used.
+        const bool oil = FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx);
+        const bool gas = FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx);
+        const int oilpos = FluidSystem::oilPhaseIdx;
+        const int gaspos = FluidSystem::gasPhaseIdx;
+        int numCells = static_cast<int>(cellInfos.size());
+#ifdef _OPENMP
+#pragma omp parallel for if(swatInit_.empty())
+#endif
+        for (int i = 0; i < numCells; ++i) {
+            const CellInfo& info = cellInfos[i];
+            const int cell = info.cellIdx;
+            const auto& tables = pressTables[regionTableIdx[info.regionIdx]];
+
+            try {
+                const double depth = Opm::UgGridHelpers::cellCenterDepth(grid, cell);
+
+                double press[FluidSystem::numPhases];
+                double sat[FluidSystem::numPhases];
+                for (int p = 0; p < np; ++p)
+                    press[p] = tables[p] ? tables[p](depth) : 0.0;
+
+                Details::cellPhaseSaturations<FluidSystem>(grid, eqRegs[info.regionIdx], cell,
+                                                           materialLawManager, swatInit_,
+                                                           press, sat);
+
+                for (int p = 0; p < np; ++p) {
+                    pp_[p][cell] = press[p];
+                    sat_[p][cell] = sat[p];
+                }
 
-            const int np = FluidSystem::numPhases;
-            for (int p = 0; p < np; ++p) {
-                copyFromRegion(pressures[p], cells, pp_[p]);
-                copyFromRegion(sat[p], cells, sat_[p]);
+                if (oil && gas) {
+                    const double temperature = temperature_[cell];
+                    rs_[cell] = (*rsFunc_[info.regionIdx])(depth, press[oilpos], temperature, sat[gaspos]);
+                    rv_[cell] = (*rvFunc_[info.regionIdx])(depth, press[gaspos], temperature, sat[oilpos]);
+                }
             }
-            const bool oil = FluidSystem::phaseIsActive(FluidSystem::oilPhaseIdx);
-            const bool gas = FluidSystem::phaseIsActive(FluidSystem::gasPhaseIdx);
-            if (oil && gas) {
-                const int oilpos = FluidSystem::oilPhaseIdx;
-                const int gaspos = FluidSystem::gasPhaseIdx;
-                const Vec rsVals = computeRs(grid, cells, pressures[oilpos], temperature_, *(rsFunc_[r]), sat[gaspos]);
-                const Vec rvVals = computeRs(grid, cells, pressures[gaspos], temperature_, *(rvFunc_[r]), sat[oilpos]);
-                copyFromRegion(rsVals, cells, rs_);
-                copyFromRegion(rvVals, cells, rv_);
+            catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                if (!exc)
+                    exc = std::current_exception();
             }
         }
+        if (exc)
+            std::rethrow_exception(exc);
     }
 
-    template <class CellRangeType>
-    void copyFromRegion(const Vec& source,
-                        const CellRangeType& cells,
-                        Vec& destination)
+    std::vector<int> cellSatnumIdx_(const Grid& grid, const Opm::EclipseState& eclState) const
     {
-        auto s = source.begin();
-        auto c = cells.begin();
-        const auto e = cells.end();
-        for (; c != e; ++c, ++s) {
-            destination[*c] =*s;
+        const int numCells = grid.size(/*codim=*/0);
+        std::vector<int> satnum(numCells, 0);
+
+        const auto& eclProps = eclState.get3DProperties();
+        if (!eclProps.hasDeckIntGridProperty("SATNUM"))
+            return satnum;
+
+        const std::vector<int>& satnumData = eclProps.getIntGridProperty("SATNUM").getData();
+        const int* gc = Opm::UgGridHelpers::globalCell(grid);
+        for (int cell = 0; cell < numCells; ++cell) {
+            const int deckPos = (gc == NULL) ? cell : gc[cell];
+            satnum[cell] = satnumData[deckPos] - 1;
         }
-    }
 
+        return satnum;
+    }
 };
 } // namespace DeckDependent
 } // namespace EQUIL
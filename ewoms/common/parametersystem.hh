@@ -40,6 +40,10 @@
 #include <dune/common/classname.hh>
 #include <dune/common/parametertree.hh>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <map>
 #include <set>
 #include <list>
@@ -147,6 +151,9 @@ const ParamType get(const char *propTagName,
                     const char *paramName,
                     bool errorIfNotRegistered = true);
 
+template <class TypeTag>
+void resolveValues();
+
 class ParamRegFinalizerBase_
 {
 public:
@@ -165,8 +172,8 @@ public:
 
     void retrieve()
     {
-        // retrieve the parameter once to make sure that its value does
-        // not contain a syntax error.
+        // retrieve the parameter to make sure that its value does not contain a syntax
+        // error. this also puts the value into the parameter's cache.
         ParamType __attribute__((unused)) dummy =
             get<TypeTag, ParamType, PropTag>(/*propTagName=*/paramName_.data(),
                                              paramName_.data(),
@@ -194,9 +201,34 @@ SET_PROP(ParameterSystem, ParameterMetaData)
 {
     typedef Dune::ParameterTree type;
 
+    /*!
+     * \brief Returns the parameter tree for modification.
+     *
+     * Since the tree may be changed by the caller, this invalidates the cached values
+     * of all parameters.
+     */
     static Dune::ParameterTree& tree()
+    {
+        ++storage_().treeRevision;
+        return storage_().tree;
+    }
+
+    /*!
+     * \brief Returns the parameter tree for read-only access.
+     */
+    static const Dune::ParameterTree& constTree()
     { return storage_().tree; }
 
+    /*!
+     * \brief Returns a number which changes whenever the parameter tree may have been
+     *        modified.
+     *
+     * The cached parameter values are only valid if they have been retrieved using the
+     * current revision of the tree.
+     */
+    static unsigned treeRevision()
+    { return storage_().treeRevision; }
+
     static std::map<std::string, ::Ewoms::Parameters::ParamInfo>& mutableRegistry()
     { return storage_().registry; }
 
@@ -217,12 +249,22 @@ private:
     // times...
     struct Storage_ {
         Storage_()
-        { registrationOpen = true; }
+        {
+            registrationOpen = true;
+            treeRevision = 1;
+        }
+
+        ~Storage_()
+        {
+            for (auto* finalizer : finalizers)
+                delete finalizer;
+        }
 
         Dune::ParameterTree tree;
         std::map<std::string, ::Ewoms::Parameters::ParamInfo> registry;
         std::list< ::Ewoms::Parameters::ParamRegFinalizerBase_ *> finalizers;
         bool registrationOpen;
+        unsigned treeRevision;
     };
     static Storage_& storage_() {
         static Storage_ obj;
@@ -328,7 +370,7 @@ void printParamList_(std::ostream& os, const std::list<std::string>& keyList, bo
 {
     typedef typename GET_PROP(TypeTag, ParameterMetaData) ParamsMeta;
 
-    const Dune::ParameterTree& tree = ParamsMeta::tree();
+    const Dune::ParameterTree& tree = ParamsMeta::constTree();
 
     auto keyIt = keyList.begin();
     const auto& keyEndIt = keyList.end();
@@ -688,7 +730,7 @@ void printValues(std::ostream& os = std::cout)
 {
     typedef typename GET_PROP(TypeTag, ParameterMetaData) ParamsMeta;
 
-    const Dune::ParameterTree& tree = ParamsMeta::tree();
+    const Dune::ParameterTree& tree = ParamsMeta::constTree();
 
     std::list<std::string> runTimeAllKeyList;
     std::list<std::string> runTimeKeyList;
@@ -756,7 +798,7 @@ bool printUnused(std::ostream& os = std::cout)
 {
     typedef typename GET_PROP(TypeTag, ParameterMetaData) ParamsMeta;
 
-    const Dune::ParameterTree& tree = ParamsMeta::tree();
+    const Dune::ParameterTree& tree = ParamsMeta::constTree();
     std::list<std::string> runTimeAllKeyList;
     std::list<std::string> unknownKeyList;
 
@@ -800,6 +842,22 @@ public:
     }
 
 private:
+    // the value of a parameter which was retrieved from the parameter tree. there is
+    // exactly one of these objects for each parameter, so looking it up does not involve
+    // any string operations.
+    template <class ParamType, class PropTag>
+    struct CachedValue_
+    {
+        static CachedValue_& instance()
+        {
+            static CachedValue_ obj;
+            return obj;
+        }
+
+        ParamType value;
+        unsigned treeRevision = 0; // 0 means that no value has been cached yet
+    };
+
     struct Blubb
     {
         std::string propertyName;
@@ -847,26 +905,55 @@ private:
     }
 
     template <class ParamType, class PropTag>
-    static const ParamType retrieve_(const char OPM_OPTIM_UNUSED *propTagName,
+    static const ParamType retrieve_(const char *propTagName,
                                      const char *paramName,
                                      bool errorIfNotRegistered = true)
     {
+        // the cache is only populated for registered parameters after the registration
+        // has been closed. if the parameter tree was not modified since the value was
+        // cached, no further checks are required.
+        const auto& cachedValue = CachedValue_<ParamType, PropTag>::instance();
+        if (cachedValue.treeRevision == ParamsMeta::treeRevision())
+            return cachedValue.value;
+
+        return retrieveUncached_<ParamType, PropTag>(propTagName,
+                                                     paramName,
+                                                     errorIfNotRegistered);
+    }
+
+    template <class ParamType, class PropTag>
+    static const ParamType retrieveUncached_(const char OPM_OPTIM_UNUSED *propTagName,
+                                             const char *paramName,
+                                             bool errorIfNotRegistered)
+    {
 #ifndef NDEBUG
         // make sure that the parameter is used consistently. since
         // this is potentially quite expensive, it is only done if
         // debugging code is not explicitly turned off.
         check_(Dune::className<ParamType>(), propTagName, paramName);
+
+#ifdef _OPENMP
+        // the parameter tree and the cached values are not thread-safe. all parameters
+        // are resolved after the parameter tree has been set up, so a cache miss inside
+        // of a threaded region means that a parameter was either accessed before the
+        // parameters have been finalized or that the tree was modified in between.
+        if (omp_in_parallel())
+            throw std::logic_error("Parameter "+std::string(paramName)+" must not be "
+                                   "retrieved from the parameter tree inside of a "
+                                   "threaded region.");
+#endif
 #endif
 
-        typedef typename GET_PROP(TypeTag, ParameterMetaData) ParamsMeta;
-        if (errorIfNotRegistered) {
+        bool isRegistered =
+            !ParamsMeta::registrationOpen()
+            && ParamsMeta::registry().find(paramName) != ParamsMeta::registry().end();
+        if (errorIfNotRegistered && !isRegistered) {
             if (ParamsMeta::registrationOpen())
                 throw std::runtime_error("Parameters can only retieved after _all_ of them have "
                                          "been registered.");
 
-            if (ParamsMeta::registry().find(paramName) == ParamsMeta::registry().end())
-                throw std::runtime_error("Accessing parameter "+std::string(paramName)
-                                         +" without prior registration is not allowed.");
+            throw std::runtime_error("Accessing parameter "+std::string(paramName)
+                                     +" without prior registration is not allowed.");
         }
 
         // prefix the parameter name by the model's GroupName. E.g. If
@@ -879,7 +966,16 @@ private:
 
         // retrieve actual parameter from the parameter tree
         const ParamType defaultValue = GET_PROP_VALUE_(TypeTag, PropTag);
-        return ParamsMeta::tree().template get<ParamType>(canonicalName, defaultValue  );
+        const ParamType value =
+            ParamsMeta::constTree().template get<ParamType>(canonicalName, defaultValue);
+
+        if (isRegistered) {
+            auto& cachedValue = CachedValue_<ParamType, PropTag>::instance();
+            cachedValue.value = value;
+            cachedValue.treeRevision = ParamsMeta::treeRevision();
+        }
+
+        return value;
     }
 };
 
@@ -958,12 +1054,51 @@ void endParamRegistration()
 
     // loop over all parameters and retrieve their values to make sure
     // that there is no syntax error
-    auto pIt = ParamsMeta::registrationFinalizers().begin();
-    const auto& pEndIt = ParamsMeta::registrationFinalizers().end();
-    for (; pIt != pEndIt; ++pIt) {
-        (*pIt)->retrieve();
-        delete *pIt;
-    }
+    resolveValues<TypeTag>();
+}
+
+/*!
+ * \ingroup Parameter
+ * \brief Retrieve the values of all registered parameters from the parameter tree.
+ *
+ * This needs to be called after the parameter tree was modified, e.g., after the
+ * command line and the parameter file have been parsed. Afterwards, \c EWOMS_GET_PARAM
+ * only consists of reading the cached value of the parameter, i.e., it does not need to
+ * access the parameter tree and may thus also be used inside of threaded regions.
+ */
+template <class TypeTag>
+void resolveValues()
+{
+    typedef typename GET_PROP(TypeTag, ParameterMetaData) ParamsMeta;
+    if (ParamsMeta::registrationOpen())
+        throw std::logic_error("Parameter values can only be resolved after the "
+                               "registration has been closed.");
+
+    for (auto* finalizer : ParamsMeta::registrationFinalizers())
+        finalizer->retrieve();
+}
+
+/*!
+ * \ingroup Parameter
+ * \brief Forget about all registered parameters and their values.
+ *
+ * Afterwards, the parameters can be registered again. This is required if the
+ * parameters need to be evaluated before the type tag which is used for the simulation
+ * is known.
+ */
+template <class TypeTag>
+void reset()
+{
+    typedef typename GET_PROP(TypeTag, ParameterMetaData) ParamsMeta;
+
+    for (auto* finalizer : ParamsMeta::registrationFinalizers())
+        delete finalizer;
+    ParamsMeta::registrationFinalizers().clear();
+    ParamsMeta::mutableRegistry().clear();
+
+    // this also invalidates the cached values of all parameters
+    ParamsMeta::tree() = Dune::ParameterTree();
+    ParamsMeta::registrationOpen() = true;
 }
 //! \endcond
 
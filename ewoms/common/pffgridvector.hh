@@ -28,10 +28,12 @@
 #define EWOMS_PFF_GRID_VECTOR_HH
 
 #include <ewoms/common/prefetch.hh>
+#include <ewoms/parallel/threadedentityiterator.hh>
 
 #include <dune/grid/common/mcmgmapper.hh>
 #include <dune/common/version.hh>
 
+#include <exception>
 #include <vector>
 
 namespace Ewoms {
@@ -43,6 +45,10 @@ namespace Ewoms {
  * performance. On the flipside data cannot be written to on an individual basis and it
  * requires significantly more memory than a plain array. PffVector stands for "PreFetch
  * Friendly Grid Vector".
+ *
+ * Since the data of the neighbors of an element are stored contiguously, this
+ * container is also well suited to store per-face records, i.e., everything which is
+ * needed to compute the flux between the center of a stencil and one of its neighbors.
  */
 template <class GridView, class Stencil, class Data, class DofMapper>
 class PffGridVector
@@ -66,36 +72,62 @@ public:
         , dofMapper_(dofMapper)
     { }
 
+    /*!
+     * \brief Fill the data of all degrees of freedom of all elements.
+     *
+     * The offsets of the data of each element are determined sequentially, the
+     * distribution function is then called concurrently for different elements. It
+     * thus must be safe to call it from multiple threads at the same time.
+     */
     template <class DistFn>
     void update(const DistFn& distFn)
     {
         unsigned numElements = gridView_.size(/*codim=*/0);
-        unsigned numLocalDofs = computeNumLocalDofs_();
+
+        std::vector<unsigned> elemOffsets;
+        unsigned numLocalDofs = computeElementOffsets_(elemOffsets);
 
         elemData_.resize(numElements);
         data_.resize(numLocalDofs);
 
-        // update the pointers for the element data: for this, we need to loop over the
-        // whole grid and update a stencil for each element
-        Data *curElemDataPtr = &data_[0];
-        Stencil stencil(gridView_, dofMapper_);
-        auto elemIt = gridView_.template begin</*codim=*/0>();
-        const auto& elemEndIt = gridView_.template end</*codim=*/0>();
-        for (; elemIt != elemEndIt; ++elemIt) {
-            // set the DOF data pointer for the current element
-            const auto& elem = *elemIt;
-            unsigned elemIdx = elementMapper_.index(elem);
-            elemData_[elemIdx] = curElemDataPtr;
-
-            stencil.update(elem);
-            unsigned numDof = stencil.numDof();
-            for (unsigned localDofIdx = 0; localDofIdx < numDof; ++ localDofIdx)
-                distFn(curElemDataPtr[localDofIdx], stencil, localDofIdx);
-
-            // update the element data pointer to make it point to the beginning of the
-            // data for DOFs of the next element
-            curElemDataPtr += numDof;
+        // update the pointers for the element data
+        for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx)
+            elemData_[elemIdx] = data_.data() + elemOffsets[elemIdx];
+
+        // call the distribution function for all DOFs of all elements. since each
+        // element only writes to its own slice of the data array, no locking is
+        // required. exceptions must not escape from the threaded region, so the first
+        // one is stored and re-thrown afterwards.
+        std::exception_ptr exc;
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            Stencil stencil(gridView_, dofMapper_);
+            try {
+                auto elemIt = threadedElemIt.beginParallel();
+                for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                    const auto& elem = *elemIt;
+                    Data *elemDataPtr = elemData_[elementMapper_.index(elem)];
+
+                    stencil.update(elem);
+                    unsigned numDof = stencil.numDof();
+                    for (unsigned localDofIdx = 0; localDofIdx < numDof; ++ localDofIdx)
+                        distFn(elemDataPtr[localDofIdx], stencil, localDofIdx);
+                }
+            }
+            catch (...) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                if (!exc)
+                    exc = std::current_exception();
+            }
         }
+
+        if (exc)
+            std::rethrow_exception(exc);
     }
 
     void prefetch(const Element& elem) const
@@ -114,15 +146,18 @@ public:
     }
 
 private:
-    unsigned computeNumLocalDofs_() const
+    unsigned computeElementOffsets_(std::vector<unsigned>& elemOffsets) const
     {
         unsigned result = 0;
+        elemOffsets.resize(gridView_.size(/*codim=*/0));
 
         // loop over the whole grid and sum up the number of local DOFs of all Stencils
         Stencil stencil(gridView_, dofMapper_);
         auto elemIt = gridView_.template begin</*codim=*/0>();
         const auto& elemEndIt = gridView_.template end</*codim=*/0>();
         for (; elemIt != elemEndIt; ++elemIt) {
+            elemOffsets[elementMapper_.index(*elemIt)] = result;
+
             stencil.update(*elemIt);
             result += stencil.numDof();
         }
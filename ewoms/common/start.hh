@@ -174,6 +174,10 @@ static inline int setupParameters_(int argc, const char **argv, bool registerPar
         Parameters::parseParameterFile<TypeTag>(paramFileName, /*overwrite=*/false);
     }
 
+    // the parameter tree is now complete, so retrieve the values of all parameters once
+    // instead of accessing the tree whenever a parameter is requested
+    Parameters::resolveValues<TypeTag>();
+
     return /*status=*/0;
 }
 
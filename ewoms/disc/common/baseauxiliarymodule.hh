@@ -120,6 +120,16 @@ public:
      */
     virtual void linearize(JacobianMatrix& matrix, GlobalEqVector& residual) = 0;
 
+    /*!
+     * \brief Returns true if the auxiliary module can be linearized concurrently with
+     *        other auxiliary modules.
+     *
+     * This requires that the linearize() method only writes to entries of the matrix
+     * and of the residual which are not written to by any other auxiliary module.
+     */
+    virtual bool linearizationIsThreadSafe() const
+    { return false; }
+
     /*!
      * \brief This method is called after the linear solver has been called but before
      *        the solution is updated for the next iteration.
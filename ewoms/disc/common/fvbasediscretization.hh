@@ -75,8 +75,10 @@
 #include <dune/fem/misc/capabilities.hh>
 #endif
 
+#include <atomic>
 #include <limits>
 #include <list>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -212,6 +214,11 @@ SET_TYPE_PROP(FvBaseDiscretization, ThreadManager, Ewoms::ThreadManager<TypeTag>
 SET_INT_PROP(FvBaseDiscretization, ThreadsPerProcess, 1);
 SET_BOOL_PROP(FvBaseDiscretization, UseLinearizationLock, true);
 
+//! re-linearize all elements in each Newton iteration by default
+SET_BOOL_PROP(FvBaseDiscretization, EnableLocalizedLinearization, false);
+SET_SCALAR_PROP(FvBaseDiscretization, LocalizedLinearizationTolerance, 1e-4);
+SET_SCALAR_PROP(FvBaseDiscretization, LocalizedLinearizationMaxActiveFraction, 0.5);
+
 /*!
  * \brief Linearizer for the global system of equations.
  */
@@ -347,6 +354,111 @@ class FvBaseDiscretization
         { return blockVector_; }
     };
 
+    // Keeps track of the entries of the intensive quantity cache for a time level which
+    // are up to date. Each entry stores the generation in which it was last modified and
+    // it is valid if that generation matches the epoch of the time level. This means
+    // that the whole time level can be invalidated in O(1) by advancing the epoch. Since
+    // every entry is an individual word, concurrent updates of different entries do not
+    // interfere, and concurrent updates of the same entry are serialized by claiming it
+    // first.
+    class CacheValidity
+    {
+        // the generation of an entry relative to the epoch of the time level. entries
+        // with an older generation have not been touched since the epoch was advanced.
+        enum {
+            validOffset = 0,
+            invalidatedOffset = 1,
+            busyOffset = 2,
+            epochIncrement = 4
+        };
+
+    public:
+        CacheValidity()
+            : size_(0)
+            , epoch_(epochIncrement)
+        {}
+
+        void resize(size_t numEntries)
+        {
+            generation_.reset(new std::atomic<unsigned>[numEntries]);
+            size_ = numEntries;
+            reset_();
+        }
+
+        /*!
+         * \brief Returns true if the cache entry is up to date.
+         */
+        bool isValid(size_t idx) const
+        { return generation_[idx].load(std::memory_order_acquire) == epoch_ + validOffset; }
+
+        /*!
+         * \brief Returns true if the cache entry was explicitly marked as invalid since the
+         *        last time the epoch was advanced.
+         */
+        bool isInvalidated(size_t idx) const
+        { return generation_[idx].load(std::memory_order_relaxed) == epoch_ + invalidatedOffset; }
+
+        /*!
+         * \brief Explicitly mark a cache entry as valid or invalid.
+         */
+        void setValid(size_t idx, bool yesno)
+        {
+            unsigned gen = epoch_ + (yesno ? validOffset : invalidatedOffset);
+            generation_[idx].store(gen, std::memory_order_release);
+        }
+
+        /*!
+         * \brief Claim the right to modify a cache entry.
+         *
+         * This returns false if the entry is already up to date or if it is currently
+         * being modified by another thread. Otherwise the caller must call endUpdate()
+         * after it has written the entry.
+         */
+        bool beginUpdate(size_t idx)
+        {
+            unsigned gen = generation_[idx].load(std::memory_order_relaxed);
+            if (gen == epoch_ + validOffset || gen == epoch_ + busyOffset)
+                return false;
+
+            return generation_[idx].compare_exchange_strong(gen,
+                                                            epoch_ + busyOffset,
+                                                            std::memory_order_acquire);
+        }
+
+        /*!
+         * \brief Publish a cache entry which was claimed using beginUpdate().
+         */
+        void endUpdate(size_t idx)
+        { generation_[idx].store(epoch_ + validOffset, std::memory_order_release); }
+
+        /*!
+         * \brief Mark all entries as invalid.
+         *
+         * This must not be called concurrently with any other method.
+         */
+        void invalidateAll()
+        {
+            if (epoch_ > std::numeric_limits<unsigned>::max() - 2*epochIncrement)
+                // the generation counters would overflow. this is very rare, so we can
+                // afford to reset all entries explicitly.
+                reset_();
+            else
+                epoch_ += epochIncrement;
+        }
+
+    private:
+        void reset_()
+        {
+            for (size_t idx = 0; idx < size_; ++idx)
+                generation_[idx].store(0, std::memory_order_relaxed);
+            epoch_ = epochIncrement;
+        }
+
+        std::unique_ptr<std::atomic<unsigned>[]> generation_;
+        size_t size_;
+        unsigned epoch_;
+    };
+
 #if HAVE_DUNE_FEM
     typedef typename GET_PROP_TYPE(TypeTag, DiscreteFunctionSpace)    DiscreteFunctionSpace;
 
@@ -396,6 +508,8 @@ public:
         , enableIntensiveQuantityCache_(EWOMS_GET_PARAM(TypeTag, bool, EnableIntensiveQuantityCache))
         , enableStorageCache_(EWOMS_GET_PARAM(TypeTag, bool, EnableStorageCache))
         , enableThermodynamicHints_(EWOMS_GET_PARAM(TypeTag, bool, EnableThermodynamicHints))
+        , timeLevelHead_(0)
+        , headMirrorsPreviousTimeLevel_(false)
     {
 #if HAVE_DUNE_FEM
         if (enableGridAdaptation_ && !Dune::Fem::Capabilities::isLocallyAdaptive<Grid>::v)
@@ -420,7 +534,7 @@ public:
 
             if (storeIntensiveQuantities()) {
                 intensiveQuantityCache_[timeIdx].resize(numDof);
-                intensiveQuantityCacheUpToDate_[timeIdx].resize(numDof, /*value=*/false);
+                intensiveQuantityCacheValidity_[timeIdx].resize(numDof);
             }
 
             if (enableStorageCache_)
@@ -657,8 +771,7 @@ public:
      */
     const IntensiveQuantities* cachedIntensiveQuantities(unsigned globalIdx, unsigned timeIdx) const
     {
-        if (!enableIntensiveQuantityCache_ ||
-            !intensiveQuantityCacheUpToDate_[timeIdx][globalIdx])
+        if (!enableIntensiveQuantityCache_)
             return 0;
 
         if (timeIdx > 0 && enableStorageCache_)
@@ -666,12 +779,34 @@ public:
             // recent time step are cached!
             return 0;
 
-        return &intensiveQuantityCache_[timeIdx][globalIdx];
+        unsigned slotIdx = timeLevelSlot_(timeIdx);
+        const auto& validity = intensiveQuantityCacheValidity_[slotIdx];
+        if (validity.isValid(globalIdx))
+            return &intensiveQuantityCache_[slotIdx][globalIdx];
+
+        if (timeIdx == 0
+            && headMirrorsPreviousTimeLevel_
+            && !validity.isInvalidated(globalIdx))
+        {
+            // the solution of the entity has not been modified since the solution of
+            // the most recent time level was set to the one of the previous time
+            // level. we can thus use the intensive quantities of the previous time
+            // level.
+            unsigned prevSlotIdx = timeLevelSlot_(/*timeIdx=*/1);
+            if (intensiveQuantityCacheValidity_[prevSlotIdx].isValid(globalIdx))
+                return &intensiveQuantityCache_[prevSlotIdx][globalIdx];
+        }
+
+        return 0;
     }
 
     /*!
      * \brief Update the intensive quantity cache for a entity on the grid at given time.
      *
+     * This method may be called concurrently by multiple threads. If the entry is
+     * already up to date or if it is currently being updated by another thread, the
+     * cache is not modified.
+     *
      * \param intQuants The IntensiveQuantities object hint for a given degree of freedom.
      * \param globalIdx The global space index for the entity where a
      *                  hint is to be set.
@@ -684,8 +819,19 @@ public:
         if (!storeIntensiveQuantities())
             return;
 
-        intensiveQuantityCache_[timeIdx][globalIdx] = intQuants;
-        intensiveQuantityCacheUpToDate_[timeIdx][globalIdx] = true;
+        // while the most recent time level mirrors the previous one, the cache of the
+        // previous time level must only contain intensive quantities which were
+        // computed for the most recent time level, i.e., including their derivatives.
+        if (timeIdx == 1 && headMirrorsPreviousTimeLevel_)
+            return;
+
+        unsigned slotIdx = timeLevelSlot_(timeIdx);
+        auto& validity = intensiveQuantityCacheValidity_[slotIdx];
+        if (!validity.beginUpdate(globalIdx))
+            return;
+
+        intensiveQuantityCache_[slotIdx][globalIdx] = intQuants;
+        validity.endUpdate(globalIdx);
     }
 
     /*!
@@ -702,53 +848,25 @@ public:
         if (!storeIntensiveQuantities())
             return;
 
-        intensiveQuantityCacheUpToDate_[timeIdx][globalIdx] = newValue;
+        intensiveQuantityCacheValidity_[timeLevelSlot_(timeIdx)].setValid(globalIdx, newValue);
     }
 
     /*!
      * \brief Invalidate the whole intensive quantity cache for time index.
      *
+     * This is an O(1) operation, but it must not be called from within a threaded
+     * region.
+     *
      * \param timeIdx The index used by the time discretization.
      */
     void invalidateIntensiveQuantitiesCache(unsigned timeIdx) const
     {
         if (storeIntensiveQuantities()) {
-            std::fill(intensiveQuantityCacheUpToDate_[timeIdx].begin(),
-                      intensiveQuantityCacheUpToDate_[timeIdx].end(),
-                      /*value=*/false);
-        }
-    }
+            intensiveQuantityCacheValidity_[timeLevelSlot_(timeIdx)].invalidateAll();
 
-    /*!
-     * \brief Move the intensive quantities for a given time index to the back.
-     *
-     * This method should only be called by the time discretization.
-     *
-     * \param numSlots The number of time step slots for which the
-     *                 hints should be shifted.
-     */
-    void shiftIntensiveQuantityCache(unsigned numSlots = 1)
-    {
-        if (!storeIntensiveQuantities())
-            return;
-
-        if (enableStorageCache()) {
-            // if the storage term is cached, the intensive quantities of the previous
-            // time steps do not need to be accessed, and we can thus spare ourselves to
-            // copy the objects for the intensive quantities.
-            return;
+            if (timeIdx == 0)
+                headMirrorsPreviousTimeLevel_ = false;
         }
-
-        assert(numSlots > 0);
-
-        for (unsigned timeIdx = 0; timeIdx < historySize - numSlots; ++ timeIdx) {
-            intensiveQuantityCache_[timeIdx + numSlots] = intensiveQuantityCache_[timeIdx];
-            intensiveQuantityCacheUpToDate_[timeIdx + numSlots] = intensiveQuantityCacheUpToDate_[timeIdx];
-        }
-
-        // the cache for the most recent time indices do not need to be invalidated
-        // because the solution for them did not change (TODO: that assumes that there is
-        // no post-processing of the solution after a time step! fix it?)
     }
 
     /*!
@@ -760,6 +878,17 @@ public:
     bool enableStorageCache() const
     { return enableStorageCache_; }
 
+    /*!
+     * \brief Returns true iff the element contexts need to compute the intensive
+     *        quantities of the previous time levels.
+     *
+     * This is the case if the storage term is not cached. Models which keep the
+     * quantities required for the storage term of the previous time levels elsewhere
+     * can overload this method.
+     */
+    bool needOldIntensiveQuantities() const
+    { return !enableStorageCache_; }
+
     /*!
      * \brief Retrieve an entry of the cache for the storage term.
      *
@@ -773,7 +902,7 @@ public:
     const EqVector& cachedStorage(unsigned globalIdx, unsigned timeIdx) const
     {
         assert(enableStorageCache_);
-        return storageCache_[timeIdx][globalIdx];
+        return storageCache_[timeLevelSlot_(timeIdx)][globalIdx];
     }
 
     /*!
@@ -790,7 +919,7 @@ public:
     void updateCachedStorage(unsigned globalIdx, unsigned timeIdx, const EqVector& value) const
     {
         assert(enableStorageCache_);
-        storageCache_[timeIdx][globalIdx] = value;
+        storageCache_[timeLevelSlot_(timeIdx)][globalIdx] = value;
     }
 
     /*!
@@ -1071,20 +1200,20 @@ public:
      * \param timeIdx The index of the solution used by the time discretization.
      */
     const SolutionVector& solution(unsigned timeIdx) const
-    { return solution_[timeIdx]->blockVector(); }
+    { return solution_[solutionSlot_(timeIdx)]->blockVector(); }
 
     /*!
      * \copydoc solution(int) const
      */
     SolutionVector& solution(unsigned timeIdx)
-    { return solution_[timeIdx]->blockVector(); }
+    { return solution_[solutionSlot_(timeIdx)]->blockVector(); }
 
   protected:
     /*!
      * \copydoc solution(int) const
      */
     SolutionVector& mutableSolution(unsigned timeIdx) const
-    { return solution_[timeIdx]->blockVector(); }
+    { return solution_[solutionSlot_(timeIdx)]->blockVector(); }
 
   public:
     /*!
@@ -1336,6 +1465,10 @@ public:
         // previous time step so that we can start the next
         // update at a physically meaningful solution.
         solution(/*timeIdx=*/0) = solution(/*timeIdx=*/1);
+
+        // the cached intensive quantities of the previous time level cannot be used for
+        // the most recent one here: if the storage term is not cached, they may have
+        // been computed for time index 1, i.e., without any derivatives.
         invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
 
 #ifndef NDEBUG
@@ -1361,12 +1494,26 @@ public:
         // at this point we can adapt the grid
         asImp_().adaptGrid();
 
-        // make the current solution the previous one.
-        solution(/*timeIdx=*/1) = solution(/*timeIdx=*/0);
+        // shift the whole history by one position. this makes the current solution,
+        // its intensive quantities and its storage term the ones of the previous time
+        // level without copying them.
+        rotateTimeLevels_();
 
-        // shift the intensive quantities cache by one position in the
-        // history
-        asImp_().shiftIntensiveQuantityCache(/*numSlots=*/1);
+        if (enableGridAdaptation_)
+            // the most recent solution is not part of the ring buffer if the grid is
+            // adaptive, so we need to copy it
+            solution(/*timeIdx=*/1) = solution(/*timeIdx=*/0);
+        else
+            // the solution at the end of the time step is the initial guess for the
+            // next one
+            solution(/*timeIdx=*/0) = solution(/*timeIdx=*/1);
+
+        // the cached quantities for the most recent time index do not need to be
+        // recalculated because the solution for them did not change: they are the ones
+        // of the previous time level. (TODO: that assumes that there is no
+        // post-processing of the solution after a time step! fix it?)
+        if (storeIntensiveQuantities())
+            mirrorPreviousTimeLevel_();
     }
 
     /*!
@@ -1812,11 +1959,61 @@ protected:
             size_t numDof = asImp_().numGridDof();
             for(unsigned timeIdx=0; timeIdx<historySize; ++timeIdx) {
                 intensiveQuantityCache_[timeIdx].resize(numDof);
-                intensiveQuantityCacheUpToDate_[timeIdx].resize(numDof);
+                intensiveQuantityCacheValidity_[timeIdx].resize(numDof);
                 invalidateIntensiveQuantitiesCache(timeIdx);
             }
         }
     }
+
+    /*!
+     * \brief Returns the physical slot of the ring buffers for the caches which stores
+     *        a given time index.
+     */
+    unsigned timeLevelSlot_(unsigned timeIdx) const
+    {
+        assert(timeIdx < historySize);
+        return (timeLevelHead_ + timeIdx) % historySize;
+    }
+
+    /*!
+     * \brief Returns the physical slot of the ring buffer for the solution which stores
+     *        a given time index.
+     *
+     * If grid adaptation is enabled, the restriction and prolongation operators are
+     * bound to the first slot, so the most recent solution must always be stored there.
+     */
+    unsigned solutionSlot_(unsigned timeIdx) const
+    {
+        if (enableGridAdaptation_)
+            return timeIdx;
+        return timeLevelSlot_(timeIdx);
+    }
+
+    /*!
+     * \brief Rotate the ring buffers of the time history so that the data of time index
+     *        'i' becomes the one of time index 'i + 1'.
+     *
+     * The slot which becomes the most recent time level holds stale data afterwards.
+     */
+    void rotateTimeLevels_()
+    { timeLevelHead_ = (timeLevelHead_ + historySize - 1) % historySize; }
+
+    /*!
+     * \brief Specify that the solution of the most recent time level is identical to the
+     *        one of the previous time level.
+     *
+     * All intensive quantities for the most recent time level which are not explicitly
+     * updated afterwards are then taken from the cache of the previous time level. This
+     * must only be called directly after the time levels have been rotated, because only
+     * then the cache of the previous time level exclusively holds intensive quantities
+     * which were computed for time index 0.
+     */
+    void mirrorPreviousTimeLevel_() const
+    {
+        invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
+        headMirrorsPreviousTimeLevel_ = true;
+    }
+
     template <class Context>
     void supplementInitialSolution_(PrimaryVariables& priVars OPM_UNUSED,
                                     const Context& context OPM_UNUSED,
@@ -1883,9 +2080,10 @@ protected:
     Linearizer *linearizer_;
 
     // cur is the current iterative solution, prev the converged
-    // solution of the previous time step
+    // solution of the previous time step. all arrays which are indexed by the time
+    // level are ring buffers, i.e., use timeLevelSlot_() to access them.
     mutable IntensiveQuantitiesVector intensiveQuantityCache_[historySize];
-    mutable std::vector<bool> intensiveQuantityCacheUpToDate_[historySize];
+    mutable CacheValidity intensiveQuantityCacheValidity_[historySize];
 
     DiscreteFunctionSpace space_;
     mutable std::array< std::unique_ptr< DiscreteFunction >, historySize > solution_;
@@ -1908,6 +2106,13 @@ protected:
     bool enableIntensiveQuantityCache_;
     bool enableStorageCache_;
     bool enableThermodynamicHints_;
+
+    // the slot of the ring buffers which stores the most recent time level
+    unsigned timeLevelHead_;
+
+    // true if the solution of the most recent time level has not been modified since
+    // it was set to the one of the previous time level
+    mutable bool headMirrorsPreviousTimeLevel_;
 };
 } // namespace Ewoms
 
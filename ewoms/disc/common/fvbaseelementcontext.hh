@@ -183,9 +183,10 @@ public:
      */
     void updateAllIntensiveQuantities()
     {
-        if (!enableStorageCache_) {
+        if (!enableStorageCache_ && model().needOldIntensiveQuantities()) {
             // if the storage cache is disabled, we need to calculate the storage term
-            // from scratch, i.e. we need the intensive quantities of all of the history.
+            // from scratch, i.e. we need the intensive quantities of all of the history
+            // unless the model provides them by other means.
             for (unsigned timeIdx = 0; timeIdx < timeDiscHistorySize; ++ timeIdx)
                 asImp_().updateIntensiveQuantities(timeIdx);
         }
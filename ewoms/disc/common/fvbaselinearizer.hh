@@ -42,10 +42,13 @@
 #include <dune/common/fmatrix.hh>
 
 #include <type_traits>
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <thread>
 #include <set>
+#include <cmath>
+#include <cassert>
 
 namespace Ewoms {
 // forward declarations
@@ -112,6 +115,11 @@ public:
         simulatorPtr_ = 0;
 
         matrix_ = 0;
+
+        enableLocalizedLinearization_ = false;
+        haveLocalContributions_ = false;
+        linearizationIsLocalized_ = false;
+        forceFullLinearization_ = false;
     }
 
     ~FvBaseLinearizer()
@@ -127,7 +135,18 @@ public:
      * \brief Register all run-time parameters for the Jacobian linearizer.
      */
     static void registerParameters()
-    { }
+    {
+        EWOMS_REGISTER_PARAM(TypeTag, bool, EnableLocalizedLinearization,
+                             "Only re-linearize the elements affected by a non-negligible "
+                             "change of the solution after the first Newton iteration");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, LocalizedLinearizationTolerance,
+                             "The weighted change of a primary variable above which a degree "
+                             "of freedom is considered to be changed by the localized "
+                             "linearization");
+        EWOMS_REGISTER_PARAM(TypeTag, Scalar, LocalizedLinearizationMaxActiveFraction,
+                             "The fraction of changed degrees of freedom above which the "
+                             "localized linearization re-linearizes all elements");
+    }
 
     /*!
      * \brief Initialize the linearizer.
@@ -143,6 +162,11 @@ public:
         simulatorPtr_ = &simulator;
         delete matrix_; // <- note that this even works for nullpointers!
         matrix_ = 0;
+
+        enableLocalizedLinearization_ = EWOMS_GET_PARAM(TypeTag, bool, EnableLocalizedLinearization);
+        localizedLinearizationTolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, LocalizedLinearizationTolerance);
+        localizedLinearizationMaxActiveFraction_ =
+            EWOMS_GET_PARAM(TypeTag, Scalar, LocalizedLinearizationMaxActiveFraction);
     }
 
     /*!
@@ -229,34 +253,31 @@ public:
     {
         auto& model = model_();
         const auto& comm = simulator_().gridView().comm();
-        for (unsigned auxModIdx = 0; auxModIdx < model.numAuxiliaryModules(); ++auxModIdx) {
-            bool succeeded = true;
-            try {
-                model.auxiliaryModule(auxModIdx)->linearize(*matrix_, residual_);
-            }
-            catch (const std::exception& e) {
-                succeeded = false;
-
-                std::cout << "rank " << simulator_().gridView().comm().rank()
-                          << " caught an exception while linearizing:" << e.what()
-                          << "\n"  << std::flush;
-            }
-#if ! DUNE_VERSION_NEWER(DUNE_COMMON, 2,5)
-            catch (const Dune::Exception& e)
-            {
-                succeeded = false;
+        int numAuxMod = static_cast<int>(model.numAuxiliaryModules());
 
-                std::cout << "rank " << simulator_().gridView().comm().rank()
-                          << " caught an exception while linearizing:" << e.what()
-                          << "\n"  << std::flush;
-            }
+        // the auxiliary modules which allow it are linearized concurrently, the
+        // remaining ones are dealt with sequentially afterwards. whether all modules
+        // succeeded is only communicated once for the whole batch.
+        int succeeded = 1;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(min:succeeded)
 #endif
+        for (int auxModIdx = 0; auxModIdx < numAuxMod; ++auxModIdx) {
+            auto* auxMod = model.auxiliaryModule(auxModIdx);
+            if (auxMod->linearizationIsThreadSafe())
+                succeeded = std::min(succeeded, linearizeAuxiliaryModule_(*auxMod));
+        }
 
-            succeeded = comm.min(succeeded);
-
-            if (!succeeded)
-                throw Opm::NumericalIssue("linearization of an auxilary equation failed");
+        for (int auxModIdx = 0; auxModIdx < numAuxMod; ++auxModIdx) {
+            auto* auxMod = model.auxiliaryModule(auxModIdx);
+            if (!auxMod->linearizationIsThreadSafe())
+                succeeded = std::min(succeeded, linearizeAuxiliaryModule_(*auxMod));
         }
+
+        succeeded = comm.min(succeeded);
+
+        if (!succeeded)
+            throw Opm::NumericalIssue("linearization of an auxilary equation failed");
     }
 
     /*!
@@ -285,6 +306,22 @@ public:
     const std::map<unsigned, Constraints>& constraintsMap() const
     { return constraintsMap_; }
 
+    /*!
+     * \brief Returns true if the most recent linearization of the domain reused the
+     *        stored contributions of some elements.
+     *
+     * In this case, the residual of these elements has not been evaluated for the
+     * current solution, so it must not be used to conclude convergence.
+     */
+    bool linearizationIsLocalized() const
+    { return linearizationIsLocalized_; }
+
+    /*!
+     * \brief Make the next linearization of the domain re-linearize all elements.
+     */
+    void forceFullLinearization()
+    { forceFullLinearization_ = true; }
+
 private:
     Simulator& simulator_()
     { return *simulatorPtr_; }
@@ -359,10 +396,26 @@ private:
         // add the additional neighbors and degrees of freedom caused by the auxiliary
         // equations
         const auto& model = model_();
+        std::vector<size_t> numStencilNeighbors(numAllDof);
+        for (unsigned dofIdx = 0; dofIdx < numAllDof; ++ dofIdx)
+            numStencilNeighbors[dofIdx] = neighbors[dofIdx].size();
+
         size_t numAuxMod = model.numAuxiliaryModules();
         for (unsigned auxModIdx = 0; auxModIdx < numAuxMod; ++auxModIdx)
             model.auxiliaryModule(auxModIdx)->addNeighbors(neighbors);
 
+        if (enableLocalizedLinearization_) {
+            // the contributions of the degrees of freedom which are coupled to an
+            // auxiliary equation (e.g., the perforated cells of a well) may change even
+            // if their own solution did not. these are thus always re-linearized.
+            size_t numGridDof = model.numGridDof();
+            auxiliaryCoupled_.assign(numGridDof, 0);
+            for (unsigned dofIdx = 0; dofIdx < numGridDof; ++ dofIdx)
+                auxiliaryCoupled_[dofIdx] = neighbors[dofIdx].size() != numStencilNeighbors[dofIdx];
+
+            createLocalContributionStorage_();
+        }
+
         // allocate space for the rows of the matrix
         for (unsigned dofIdx = 0; dofIdx < numAllDof; ++ dofIdx)
             matrix_->setrowsize(dofIdx, neighbors[dofIdx].size());
@@ -380,6 +433,163 @@ private:
         matrix_->endindices();
     }
 
+    // allocate the memory which is required to keep the local linearization of each
+    // element for the localized linearization.
+    void createLocalContributionStorage_()
+    {
+        Stencil stencil(gridView_(), model_().dofMapper() );
+
+        size_t numElements = static_cast<size_t>(gridView_().size(/*codim=*/0));
+        elemDofOffsets_.assign(numElements + 1, 0);
+        elemBlockOffsets_.assign(numElements + 1, 0);
+        elemNumPrimaryDof_.assign(numElements, 0);
+
+        // determine the size of the stored local linearization of each element
+        ElementIterator elemIt = gridView_().template begin<0>();
+        const ElementIterator elemEndIt = gridView_().template end<0>();
+        for (; elemIt != elemEndIt; ++elemIt) {
+            const Element& elem = *elemIt;
+            unsigned elemIdx = static_cast<unsigned>(elementMapper_().index(elem));
+            stencil.update(elem);
+
+            elemNumPrimaryDof_[elemIdx] = static_cast<unsigned>(stencil.numPrimaryDof());
+            elemDofOffsets_[elemIdx + 1] = stencil.numDof();
+            elemBlockOffsets_[elemIdx + 1] = stencil.numPrimaryDof()*stencil.numDof();
+        }
+
+        for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+            elemDofOffsets_[elemIdx + 1] += elemDofOffsets_[elemIdx];
+            elemBlockOffsets_[elemIdx + 1] += elemBlockOffsets_[elemIdx];
+        }
+
+        elemDofIndices_.resize(elemDofOffsets_.back());
+        for (elemIt = gridView_().template begin<0>(); elemIt != elemEndIt; ++elemIt) {
+            const Element& elem = *elemIt;
+            unsigned elemIdx = static_cast<unsigned>(elementMapper_().index(elem));
+            stencil.update(elem);
+
+            for (unsigned dofIdx = 0; dofIdx < stencil.numDof(); ++dofIdx)
+                elemDofIndices_[elemDofOffsets_[elemIdx] + dofIdx] = stencil.globalSpaceIndex(dofIdx);
+        }
+
+        elemResidual_.resize(elemDofOffsets_.back());
+        elemJacobian_.resize(elemBlockOffsets_.back());
+
+        size_t numGridDof = model_().numGridDof();
+        changedDof_.assign(numGridDof, 0);
+        lastLinearizedSolution_.resize(numGridDof);
+        haveLocalContributions_ = false;
+    }
+
+    // determine the degrees of freedom which changed significantly since their most
+    // recent linearization. returns false if all elements need to be re-linearized.
+    bool updateChangedDofs_()
+    {
+        const auto& model = model_();
+        const auto& sol = model.solution(/*timeIdx=*/0);
+        size_t numGridDof = model.numGridDof();
+
+        bool fullLinearization =
+            !haveLocalContributions_
+            || forceFullLinearization_
+            || model.newtonMethod().numIterations() == 0;
+        forceFullLinearization_ = false;
+
+        if (fullLinearization) {
+            for (unsigned dofIdx = 0; dofIdx < numGridDof; ++dofIdx)
+                lastLinearizedSolution_[dofIdx] = sol[dofIdx];
+            return false;
+        }
+
+        size_t numChanged = 0;
+        for (unsigned dofIdx = 0; dofIdx < numGridDof; ++dofIdx) {
+            // a change of the meaning of the primary variables always counts as a
+            // change, regardless of their values
+            bool changed =
+                auxiliaryCoupled_[dofIdx]
+                || primaryVarsMeaningDiffers_(sol[dofIdx], lastLinearizedSolution_[dofIdx], 0);
+            for (unsigned pvIdx = 0; pvIdx < numEq && !changed; ++pvIdx) {
+                Scalar delta = std::abs(sol[dofIdx][pvIdx] - lastLinearizedSolution_[dofIdx][pvIdx]);
+                changed = delta*model.primaryVarWeight(dofIdx, pvIdx) > localizedLinearizationTolerance_;
+            }
+
+            changedDof_[dofIdx] = changed;
+            if (changed) {
+                lastLinearizedSolution_[dofIdx] = sol[dofIdx];
+                ++ numChanged;
+            }
+        }
+
+        if (numChanged > localizedLinearizationMaxActiveFraction_*numGridDof) {
+            // too many degrees of freedom changed for the localized linearization to be
+            // worthwhile. also take the unchanged ones as the reference for the next
+            // iteration in this case.
+            for (unsigned dofIdx = 0; dofIdx < numGridDof; ++dofIdx)
+                lastLinearizedSolution_[dofIdx] = sol[dofIdx];
+            return false;
+        }
+
+        return true;
+    }
+
+    // returns true if the meaning of two sets of primary variables differs. models
+    // which switch their primary variables indicate their meaning either by
+    // primaryVarsMeaning() (e.g., black-oil) or by phasePresence() (e.g., PVS).
+    template <class PrimaryVariablesType>
+    static auto primaryVarsMeaningDiffers_(const PrimaryVariablesType& a,
+                                           const PrimaryVariablesType& b,
+                                           int)
+        -> decltype(a.primaryVarsMeaning() != b.primaryVarsMeaning())
+    { return a.primaryVarsMeaning() != b.primaryVarsMeaning(); }
+
+    template <class PrimaryVariablesType>
+    static auto primaryVarsMeaningDiffers_(const PrimaryVariablesType& a,
+                                           const PrimaryVariablesType& b,
+                                           long)
+        -> decltype(a.phasePresence() != b.phasePresence())
+    { return a.phasePresence() != b.phasePresence(); }
+
+    template <class PrimaryVariablesType>
+    static bool primaryVarsMeaningDiffers_(const PrimaryVariablesType&,
+                                           const PrimaryVariablesType&,
+                                           ...)
+    { return false; }
+
+    // returns true if the stencil of an element contains a changed degree of freedom
+    bool elementIsActive_(unsigned elemIdx) const
+    {
+        for (size_t i = elemDofOffsets_[elemIdx]; i < elemDofOffsets_[elemIdx + 1]; ++i) {
+            unsigned globalIdx = elemDofIndices_[i];
+            if (globalIdx >= changedDof_.size() || changedDof_[globalIdx])
+                return true;
+        }
+
+        return false;
+    }
+
+    // add the stored linearization of an element to the global system of equations
+    void addLocalContribution_(unsigned elemIdx)
+    {
+        if (GET_PROP_VALUE(TypeTag, UseLinearizationLock))
+            globalMatrixMutex_.lock();
+
+        size_t dofOffset = elemDofOffsets_[elemIdx];
+        size_t blockOffset = elemBlockOffsets_[elemIdx];
+        size_t numDof = elemDofOffsets_[elemIdx + 1] - dofOffset;
+        for (unsigned primaryDofIdx = 0; primaryDofIdx < elemNumPrimaryDof_[elemIdx]; ++ primaryDofIdx) {
+            unsigned globI = elemDofIndices_[dofOffset + primaryDofIdx];
+            residual_[globI] += elemResidual_[dofOffset + primaryDofIdx];
+
+            for (unsigned dofIdx = 0; dofIdx < numDof; ++ dofIdx) {
+                unsigned globJ = elemDofIndices_[dofOffset + dofIdx];
+                (*matrix_)[globJ][globI] += elemJacobian_[blockOffset + primaryDofIdx*numDof + dofIdx];
+            }
+        }
+
+        if (GET_PROP_VALUE(TypeTag, UseLinearizationLock))
+            globalMatrixMutex_.unlock();
+    }
+
     // reset the global linear system of equations.
     void resetSystem_()
     {
@@ -433,6 +643,32 @@ private:
         }
     }
 
+    // linearize a single auxiliary module. exceptions are caught because this may be
+    // called from within a threaded region.
+    int linearizeAuxiliaryModule_(BaseAuxiliaryModule<TypeTag>& auxMod)
+    {
+        try {
+            auxMod.linearize(*matrix_, residual_);
+        }
+        catch (const std::exception& e) {
+            std::cout << "rank " << simulator_().gridView().comm().rank()
+                      << " caught an exception while linearizing:" << e.what()
+                      << "\n"  << std::flush;
+            return 0;
+        }
+#if ! DUNE_VERSION_NEWER(DUNE_COMMON, 2,5)
+        catch (const Dune::Exception& e)
+        {
+            std::cout << "rank " << simulator_().gridView().comm().rank()
+                      << " caught an exception while linearizing:" << e.what()
+                      << "\n"  << std::flush;
+            return 0;
+        }
+#endif
+
+        return 1;
+    }
+
     // linearize the whole system
     void linearize_()
     {
@@ -448,6 +684,11 @@ private:
 
         *matrix_ = 0.0;
 
+        // with the localized linearization, the elements which are not affected by a
+        // change of the solution use their most recent local linearization
+        bool localized = enableLocalizedLinearization_ && updateChangedDofs_();
+        linearizationIsLocalized_ = localized;
+
         // relinearize the elements...
         ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(gridView_());
 #ifdef _OPENMP
@@ -474,10 +715,21 @@ private:
                 if (!linearizeNonLocalElements && elem.partitionType() != Dune::InteriorEntity)
                     continue;
 
+                if (localized) {
+                    unsigned elemIdx = static_cast<unsigned>(elementMapper_().index(elem));
+                    if (!elementIsActive_(elemIdx)) {
+                        addLocalContribution_(elemIdx);
+                        continue;
+                    }
+                }
+
                 linearizeElement_(elem);
             }
         }
 
+        if (enableLocalizedLinearization_)
+            haveLocalContributions_ = true;
+
         applyConstraintsToLinearization_();
     }
 
@@ -492,6 +744,9 @@ private:
         // the actual work of linearization is done by the local linearizer class
         localLinearizer.linearize(*elementCtx, elem);
 
+        if (enableLocalizedLinearization_)
+            storeLocalContribution_(*elementCtx, localLinearizer);
+
         // update the right hand side and the Jacobian matrix
         if (GET_PROP_VALUE(TypeTag, UseLinearizationLock))
             globalMatrixMutex_.lock();
@@ -515,6 +770,28 @@ private:
             globalMatrixMutex_.unlock();
     }
 
+    // keep the local linearization of the current element for the localized
+    // linearization. each element is linearized by a single thread, so this does not
+    // require any locking.
+    template <class LocalLinearizer>
+    void storeLocalContribution_(const ElementContext& elemCtx,
+                                 const LocalLinearizer& localLinearizer)
+    {
+        unsigned elemIdx = static_cast<unsigned>(elementMapper_().index(elemCtx.element()));
+        size_t dofOffset = elemDofOffsets_[elemIdx];
+        size_t blockOffset = elemBlockOffsets_[elemIdx];
+        size_t numDof = elemCtx.numDof(/*timeIdx=*/0);
+        assert(numDof == elemDofOffsets_[elemIdx + 1] - dofOffset);
+
+        size_t numPrimaryDof = elemCtx.numPrimaryDof(/*timeIdx=*/0);
+        for (unsigned primaryDofIdx = 0; primaryDofIdx < numPrimaryDof; ++ primaryDofIdx) {
+            elemResidual_[dofOffset + primaryDofIdx] = localLinearizer.residual(primaryDofIdx);
+            for (unsigned dofIdx = 0; dofIdx < numDof; ++ dofIdx)
+                elemJacobian_[blockOffset + primaryDofIdx*numDof + dofIdx] =
+                    localLinearizer.jacobian(dofIdx, primaryDofIdx);
+        }
+    }
+
     // apply the constraints to the solution. (i.e., the solution of constraint degrees
     // of freedom is set to the value of the constraint.)
     void applyConstraintsToSolution_()
@@ -581,6 +858,23 @@ private:
 
 
     std::mutex globalMatrixMutex_;
+
+    // the state of the localized linearization
+    bool enableLocalizedLinearization_;
+    Scalar localizedLinearizationTolerance_;
+    Scalar localizedLinearizationMaxActiveFraction_;
+    bool haveLocalContributions_;
+    bool linearizationIsLocalized_;
+    bool forceFullLinearization_;
+    std::vector<unsigned char> auxiliaryCoupled_;
+    std::vector<unsigned char> changedDof_;
+    std::vector<typename SolutionVector::block_type> lastLinearizedSolution_;
+    std::vector<unsigned> elemNumPrimaryDof_;
+    std::vector<size_t> elemDofOffsets_;
+    std::vector<size_t> elemBlockOffsets_;
+    std::vector<unsigned> elemDofIndices_;
+    std::vector<VectorBlock> elemResidual_;
+    std::vector<MatrixBlock> elemJacobian_;
 };
 
 } // namespace Ewoms
@@ -137,12 +137,7 @@ protected:
 
         // make sure that the intensive quantities get recalculated at the next
         // linearization
-        if (model_().storeIntensiveQuantities()) {
-            for (unsigned dofIdx = 0; dofIdx < model_().numGridDof(); ++dofIdx)
-                model_().setIntensiveQuantitiesCacheEntryValidity(dofIdx,
-                                                                  /*timeIdx=*/0,
-                                                                  /*valid=*/false);
-        }
+        model_().invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
     }
 
     /*!
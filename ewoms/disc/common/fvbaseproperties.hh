@@ -168,6 +168,27 @@ NEW_PROP_TAG(ThreadsPerProcess);
 //! discretizations do not need this.)
 NEW_PROP_TAG(UseLinearizationLock);
 
+/*!
+ * \brief Specify whether only the elements affected by a non-negligible change of the
+ *        solution should be re-linearized in the Newton iterations after the first one.
+ *
+ * The contributions of all other elements to the global linear system of equations are
+ * taken from their most recent linearization.
+ */
+NEW_PROP_TAG(EnableLocalizedLinearization);
+
+/*!
+ * \brief The weighted change of a primary variable since the most recent linearization
+ *        above which the degree of freedom is considered to be changed.
+ */
+NEW_PROP_TAG(LocalizedLinearizationTolerance);
+
+/*!
+ * \brief The fraction of changed degrees of freedom above which all elements are
+ *        re-linearized.
+ */
+NEW_PROP_TAG(LocalizedLinearizationMaxActiveFraction);
+
 // high-level simulation control
 
 //! Manages the simulation time
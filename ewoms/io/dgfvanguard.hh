@@ -95,6 +95,7 @@ public:
 
             // this is only implemented for 2d currently
             addFractures_( dgfPointer );
+            fractureMapper_.finalize();
 
             // store pointer to dune grid
             gridPtr_.reset( dgfPointer.release() );
@@ -213,8 +213,9 @@ public:
                         intQuants.fractureRelativePermeability(phaseIdx);
                 }
                 if (volumeFractionOutput_()) {
-                    Opm::Valgrind::CheckDefined(intQuants.fractureVolume());
-                    fractureVolumeFraction_[I] += intQuants.fractureVolume();
+                    Scalar fractureVolume = elemCtx.problem().fractureVolume(elemCtx, i, /*timeIdx=*/0);
+                    Opm::Valgrind::CheckDefined(fractureVolume);
+                    fractureVolumeFraction_[I] += fractureVolume;
                 }
             }
         }
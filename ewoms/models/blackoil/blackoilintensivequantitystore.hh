@@ -0,0 +1,193 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Ewoms::BlackOilIntensiveQuantityStore
+ */
+#ifndef EWOMS_BLACK_OIL_INTENSIVE_QUANTITY_STORE_HH
+#define EWOMS_BLACK_OIL_INTENSIVE_QUANTITY_STORE_HH
+
+#include "blackoilproperties.hh"
+
+#include <opm/material/densead/Math.hpp>
+
+#include <vector>
+#include <cassert>
+
+namespace Ewoms {
+/*!
+ * \ingroup BlackOilModel
+ *
+ * \brief Stores the values of the black-oil intensive quantities of all degrees of
+ *        freedom in a structure-of-arrays layout.
+ *
+ * In contrast to the cache for the intensive quantities objects of the discretization,
+ * only the values of the quantities which are needed for the storage term are stored,
+ * i.e., their derivatives are dropped.
+ * This makes it suitable for time levels which do not require any derivatives. Since
+ * each quantity is stored in a separate contiguous array, loops over them only touch
+ * the memory which is actually needed.
+ */
+template <class TypeTag>
+class BlackOilIntensiveQuantityStore
+{
+    typedef typename GET_PROP_TYPE(TypeTag, Scalar) Scalar;
+    typedef typename GET_PROP_TYPE(TypeTag, FluidSystem) FluidSystem;
+    typedef typename GET_PROP_TYPE(TypeTag, IntensiveQuantities) IntensiveQuantities;
+
+    enum { numPhases = GET_PROP_VALUE(TypeTag, NumPhases) };
+
+    typedef std::vector<Scalar> ScalarArray;
+
+public:
+    /*!
+     * \brief Provides access to the stored quantities of a single degree of freedom.
+     *
+     * This class exhibits the part of the interfaces of the black-oil intensive
+     * quantities and of their fluid state which is used by the storage term, so it can
+     * be used in their place by code which only needs these values.
+     */
+    class Entry
+    {
+    public:
+        Entry(const BlackOilIntensiveQuantityStore& store, unsigned dofIdx)
+            : store_(store)
+            , dofIdx_(dofIdx)
+        {}
+
+        /*!
+         * \brief The entry doubles as its own fluid state.
+         */
+        const Entry& fluidState() const
+        { return *this; }
+
+        Scalar saturation(unsigned phaseIdx) const
+        { return store_.saturation_[phaseIdx][dofIdx_]; }
+
+        Scalar invB(unsigned phaseIdx) const
+        { return store_.invB_[phaseIdx][dofIdx_]; }
+
+        Scalar Rs() const
+        { return store_.Rs_[dofIdx_]; }
+
+        Scalar Rv() const
+        { return store_.Rv_[dofIdx_]; }
+
+        Scalar porosity() const
+        { return store_.porosity_[dofIdx_]; }
+
+        unsigned short pvtRegionIndex() const
+        { return store_.pvtRegionIdx_[dofIdx_]; }
+
+    private:
+        const BlackOilIntensiveQuantityStore& store_;
+        unsigned dofIdx_;
+    };
+
+    /*!
+     * \brief Set the number of degrees of freedom for which quantities are stored.
+     */
+    void resize(size_t numDof)
+    {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            saturation_[phaseIdx].resize(numDof);
+            invB_[phaseIdx].resize(numDof);
+        }
+
+        Rs_.resize(numDof);
+        Rv_.resize(numDof);
+        porosity_.resize(numDof);
+        pvtRegionIdx_.resize(numDof);
+    }
+
+    /*!
+     * \brief Returns the number of degrees of freedom for which quantities are stored.
+     */
+    size_t size() const
+    { return porosity_.size(); }
+
+    /*!
+     * \brief Store the values of the intensive quantities of a degree of freedom.
+     *
+     * \param dofIdx The global index of the degree of freedom
+     * \param intQuants The intensive quantities of the degree of freedom
+     */
+    void assign(unsigned dofIdx, const IntensiveQuantities& intQuants)
+    {
+        const auto& fs = intQuants.fluidState();
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            if (!FluidSystem::phaseIsActive(phaseIdx)) {
+                saturation_[phaseIdx][dofIdx] = 0.0;
+                invB_[phaseIdx][dofIdx] = 0.0;
+                continue;
+            }
+
+            saturation_[phaseIdx][dofIdx] = Opm::scalarValue(fs.saturation(phaseIdx));
+            invB_[phaseIdx][dofIdx] = Opm::scalarValue(fs.invB(phaseIdx));
+        }
+
+        Rs_[dofIdx] = Opm::scalarValue(fs.Rs());
+        Rv_[dofIdx] = Opm::scalarValue(fs.Rv());
+        porosity_[dofIdx] = Opm::scalarValue(intQuants.porosity());
+        pvtRegionIdx_[dofIdx] = static_cast<unsigned short>(intQuants.pvtRegionIndex());
+    }
+
+    /*!
+     * \brief Returns an object which provides access to the stored quantities of a
+     *        degree of freedom.
+     *
+     * \param dofIdx The global index of the degree of freedom
+     */
+    Entry entry(unsigned dofIdx) const
+    {
+        assert(dofIdx < size());
+        return Entry(*this, dofIdx);
+    }
+
+    /*!
+     * \brief Returns the contiguous array of the saturations of a fluid phase.
+     */
+    const ScalarArray& saturations(unsigned phaseIdx) const
+    { return saturation_[phaseIdx]; }
+
+    /*!
+     * \brief Returns the contiguous array of the inverse formation volume factors of a
+     *        fluid phase.
+     */
+    const ScalarArray& invBs(unsigned phaseIdx) const
+    { return invB_[phaseIdx]; }
+
+private:
+    ScalarArray saturation_[numPhases];
+    ScalarArray invB_[numPhases];
+    ScalarArray Rs_;
+    ScalarArray Rv_;
+    ScalarArray porosity_;
+    std::vector<unsigned short> pvtRegionIdx_;
+};
+
+} // namespace Ewoms
+
+#endif
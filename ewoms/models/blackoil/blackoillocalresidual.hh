@@ -91,42 +91,26 @@ public:
                         unsigned dofIdx,
                         unsigned timeIdx) const
     {
+        const auto& model = elemCtx.model();
+        if (timeIdx > 0 && model.useOldIntensiveQuantityStore()) {
+            // the quantities of the previous time levels do not depend on the current
+            // solution, so we only need their values. these are kept by the model.
+            unsigned globalDofIdx = elemCtx.globalSpaceIndex(dofIdx, timeIdx);
+            const auto& entry = model.oldIntensiveQuantityStore().entry(globalDofIdx);
+
+            Dune::FieldVector<Scalar, numEq> tmp;
+            computeBaseStorage_(tmp, entry);
+            for (unsigned eqIdx = 0; eqIdx < numEq; ++eqIdx)
+                storage[eqIdx] = tmp[eqIdx];
+
+            // the model extensions are disabled if the store is used, so we're done.
+            return;
+        }
+
         // retrieve the intensive quantities for the SCV at the specified point in time
         const IntensiveQuantities& intQuants = elemCtx.intensiveQuantities(dofIdx, timeIdx);
-        const auto& fs = intQuants.fluidState();
-
-        storage = 0.0;
-
-        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
-            if (!FluidSystem::phaseIsActive(phaseIdx))
-                continue;
-
-            unsigned activeCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
-            LhsEval surfaceVolume =
-                Toolbox::template decay<LhsEval>(fs.saturation(phaseIdx))
-                * Toolbox::template decay<LhsEval>(fs.invB(phaseIdx))
-                * Toolbox::template decay<LhsEval>(intQuants.porosity());
 
-            storage[conti0EqIdx + activeCompIdx] += surfaceVolume;
-
-            // account for dissolved gas
-            if (phaseIdx == oilPhaseIdx && FluidSystem::enableDissolvedGas()) {
-                unsigned activeGasCompIdx = Indices::canonicalToActiveComponentIndex(gasCompIdx);
-                storage[conti0EqIdx + activeGasCompIdx] +=
-                    Toolbox::template decay<LhsEval>(intQuants.fluidState().Rs())
-                    * surfaceVolume;
-            }
-
-            // account for vaporized oil
-            if (phaseIdx == gasPhaseIdx && FluidSystem::enableVaporizedOil()) {
-                unsigned activeOilCompIdx = Indices::canonicalToActiveComponentIndex(oilCompIdx);
-                storage[conti0EqIdx + activeOilCompIdx] +=
-                    Toolbox::template decay<LhsEval>(intQuants.fluidState().Rv())
-                    * surfaceVolume;
-            }
-        }
-
-        adaptMassConservationQuantities_(storage, intQuants.pvtRegionIndex());
+        computeBaseStorage_(storage, intQuants);
 
         // deal with solvents (if present)
         SolventModule::addStorage(storage, intQuants);
@@ -191,6 +175,54 @@ public:
             source[Indices::contiEnergyEqIdx] *= GET_PROP_VALUE(TypeTag, BlackOilEnergyScalingFactor);
     }
 
+    /*!
+     * \brief Helper function to calculate the storage term of the black-oil
+     *        conservation quantities, i.e., without the contributions of the model
+     *        extensions.
+     *
+     * The quantities can either be a black-oil intensive quantities object or an entry
+     * of the BlackOilIntensiveQuantityStore.
+     */
+    template <class LhsEval, class Quantities>
+    static void computeBaseStorage_(Dune::FieldVector<LhsEval, numEq>& storage,
+                                    const Quantities& quants)
+    {
+        const auto& fs = quants.fluidState();
+
+        storage = 0.0;
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            if (!FluidSystem::phaseIsActive(phaseIdx))
+                continue;
+
+            unsigned activeCompIdx = Indices::canonicalToActiveComponentIndex(FluidSystem::solventComponentIndex(phaseIdx));
+            LhsEval surfaceVolume =
+                Opm::decay<LhsEval>(fs.saturation(phaseIdx))
+                * Opm::decay<LhsEval>(fs.invB(phaseIdx))
+                * Opm::decay<LhsEval>(quants.porosity());
+
+            storage[conti0EqIdx + activeCompIdx] += surfaceVolume;
+
+            // account for dissolved gas
+            if (phaseIdx == oilPhaseIdx && FluidSystem::enableDissolvedGas()) {
+                unsigned activeGasCompIdx = Indices::canonicalToActiveComponentIndex(gasCompIdx);
+                storage[conti0EqIdx + activeGasCompIdx] +=
+                    Opm::decay<LhsEval>(fs.Rs())
+                    * surfaceVolume;
+            }
+
+            // account for vaporized oil
+            if (phaseIdx == gasPhaseIdx && FluidSystem::enableVaporizedOil()) {
+                unsigned activeOilCompIdx = Indices::canonicalToActiveComponentIndex(oilCompIdx);
+                storage[conti0EqIdx + activeOilCompIdx] +=
+                    Opm::decay<LhsEval>(fs.Rv())
+                    * surfaceVolume;
+            }
+        }
+
+        adaptMassConservationQuantities_(storage, quants.pvtRegionIndex());
+    }
+
     /*!
      * \brief Helper function to calculate the flux of mass in terms of conservation
      *        quantities via specific fluid phase over a face.
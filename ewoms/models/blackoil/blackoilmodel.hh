@@ -36,6 +36,7 @@
 #include "blackoilextensivequantities.hh"
 #include "blackoilprimaryvariables.hh"
 #include "blackoilintensivequantities.hh"
+#include "blackoilintensivequantitystore.hh"
 #include "blackoilratevector.hh"
 #include "blackoilboundaryratevector.hh"
 #include "blackoillocalresidual.hh"
@@ -46,6 +47,7 @@
 #include "blackoildarcyfluxmodule.hh"
 
 #include <ewoms/models/common/multiphasebasemodel.hh>
+#include <ewoms/parallel/threadedentityiterator.hh>
 #include <ewoms/io/vtkcompositionmodule.hh>
 #include <ewoms/io/vtkblackoilmodule.hh>
 
@@ -55,6 +57,8 @@
 
 #include <sstream>
 #include <string>
+#include <vector>
+#include <limits>
 
 namespace Ewoms {
 template <class TypeTag>
@@ -236,10 +240,18 @@ class BlackOilModel
     typedef typename GET_PROP_TYPE(TypeTag, Discretization) Discretization;
     typedef typename GET_PROP_TYPE(TypeTag, ElementContext) ElementContext;
     typedef typename GET_PROP_TYPE(TypeTag, PrimaryVariables) PrimaryVariables;
+    typedef typename GET_PROP_TYPE(TypeTag, GridView) GridView;
+    typedef typename GridView::template Codim<0>::Iterator ElementIterator;
+    typedef typename GridView::template Codim<0>::Entity Element;
+
+    typedef BlackOilIntensiveQuantityStore<TypeTag> IntensiveQuantityStore;
 
     enum { numPhases = GET_PROP_VALUE(TypeTag, NumPhases) };
     enum { numComponents = FluidSystem::numComponents };
     enum { numEq = GET_PROP_VALUE(TypeTag, NumEq) };
+    enum { enableSolvent = GET_PROP_VALUE(TypeTag, EnableSolvent) };
+    enum { enablePolymer = GET_PROP_VALUE(TypeTag, EnablePolymer) };
+    enum { enableEnergy = GET_PROP_VALUE(TypeTag, EnableEnergy) };
 
     static const bool compositionSwitchEnabled = Indices::gasEnabled;
     static const bool waterEnabled = Indices::waterEnabled;
@@ -250,6 +262,7 @@ class BlackOilModel
 public:
     BlackOilModel(Simulator& simulator)
         : ParentType(simulator)
+        , oldIntensiveQuantityStoreUpToDate_(false)
     {}
 
     /*!
@@ -402,6 +415,72 @@ public:
         return 1.0;
     }
 
+    /*!
+     * \brief Returns true iff the values of the intensive quantities of the previous
+     *        time level are kept in a structure-of-arrays store.
+     *
+     * This is only done if the storage term is not cached and none of the model
+     * extensions is enabled: the storage term of the previous time level then only
+     * depends on quantities which are provided by the store. The store is only read by
+     * the storage term; the fluxes are evaluated at the current time level and thus
+     * use the regular intensive quantities. In particular, ebos caches the storage
+     * term by default and thus does not use the store.
+     */
+    bool useOldIntensiveQuantityStore() const
+    {
+        return
+            !this->enableStorageCache()
+            && !enableSolvent
+            && !enablePolymer
+            && !enableEnergy;
+    }
+
+    /*!
+     * \copydoc FvBaseDiscretization::needOldIntensiveQuantities
+     */
+    bool needOldIntensiveQuantities() const
+    { return !this->enableStorageCache() && !useOldIntensiveQuantityStore(); }
+
+    /*!
+     * \brief Returns the store for the values of the intensive quantities of the
+     *        previous time level.
+     *
+     * The returned object is only valid if useOldIntensiveQuantityStore() is true.
+     */
+    const IntensiveQuantityStore& oldIntensiveQuantityStore() const
+    { return oldIntensiveQuantityStore_; }
+
+    /*!
+     * \copydoc FvBaseDiscretization::updateBegin
+     */
+    void updateBegin()
+    {
+        ParentType::updateBegin();
+
+        if (useOldIntensiveQuantityStore() && !oldIntensiveQuantityStoreUpToDate_)
+            updateOldIntensiveQuantityStore_();
+    }
+
+    /*!
+     * \copydoc FvBaseDiscretization::advanceTimeLevel
+     */
+    void advanceTimeLevel()
+    {
+        ParentType::advanceTimeLevel();
+
+        oldIntensiveQuantityStoreUpToDate_ = false;
+    }
+
+    /*!
+     * \copydoc FvBaseDiscretization::applyInitialSolution
+     */
+    void applyInitialSolution()
+    {
+        ParentType::applyInitialSolution();
+
+        oldIntensiveQuantityStoreUpToDate_ = false;
+    }
+
     /*!
      * \brief Write the current solution for a degree of freedom to a
      *        restart file.
@@ -504,6 +583,7 @@ public:
         }
 
         this->solution(/*timeIdx=*/1) = this->solution(/*timeIdx=*/0);
+        oldIntensiveQuantityStoreUpToDate_ = false;
     }
 
 /*
@@ -548,6 +628,72 @@ private:
         unsigned regionIdx = context.problem().pvtRegionIndex(context, dofIdx, timeIdx);
         priVars.setPvtRegionIndex(regionIdx);
     }
+
+    void updateOldIntensiveQuantityStore_()
+    {
+        oldIntensiveQuantityStore_.resize(this->numGridDof());
+        if (oldIntensiveQuantityStoreOwner_.size() != this->numGridDof())
+            updateOldIntensiveQuantityStoreOwners_();
+
+        // the store needs to cover all DOFs which are part of some element's stencil,
+        // so the ghost and overlap elements are not skipped here.
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(this->gridView());
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+        {
+            // Attention: the variables below are thread specific and thus cannot be
+            // moved in front of the #pragma!
+            ElementContext elemCtx(this->simulator_);
+            ElementIterator elemIt = threadedElemIt.beginParallel();
+            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
+                const Element& elem = *elemIt;
+                unsigned elemIdx = static_cast<unsigned>(this->elementMapper().index(elem));
+                elemCtx.updatePrimaryStencil(elem);
+                elemCtx.updatePrimaryIntensiveQuantities(/*timeIdx=*/1);
+
+                // primary DOFs may be shared between elements for vertex centered
+                // discretizations. only the element which owns a DOF writes its entry,
+                // so the threads never write to the same location.
+                for (unsigned dofIdx = 0; dofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/1); ++dofIdx) {
+                    unsigned globalDofIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/1);
+                    if (oldIntensiveQuantityStoreOwner_[globalDofIdx] != elemIdx)
+                        continue;
+
+                    oldIntensiveQuantityStore_.assign(globalDofIdx,
+                                                      elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/1));
+                }
+            }
+        }
+
+        oldIntensiveQuantityStoreUpToDate_ = true;
+    }
+
+    void updateOldIntensiveQuantityStoreOwners_()
+    {
+        // the grid does not change during the simulation, so the element which owns
+        // a DOF (i.e., the first one which has it as a primary DOF) is determined
+        // only once
+        oldIntensiveQuantityStoreOwner_.assign(this->numGridDof(),
+                                               std::numeric_limits<unsigned>::max());
+
+        ElementContext elemCtx(this->simulator_);
+        auto elemIt = this->gridView().template begin</*codim=*/0>();
+        const auto& elemEndIt = this->gridView().template end</*codim=*/0>();
+        for (; elemIt != elemEndIt; ++ elemIt) {
+            unsigned elemIdx = static_cast<unsigned>(this->elementMapper().index(*elemIt));
+            elemCtx.updatePrimaryStencil(*elemIt);
+            for (unsigned dofIdx = 0; dofIdx < elemCtx.numPrimaryDof(/*timeIdx=*/0); ++dofIdx) {
+                unsigned globalDofIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
+                if (oldIntensiveQuantityStoreOwner_[globalDofIdx] == std::numeric_limits<unsigned>::max())
+                    oldIntensiveQuantityStoreOwner_[globalDofIdx] = elemIdx;
+            }
+        }
+    }
+
+    IntensiveQuantityStore oldIntensiveQuantityStore_;
+    std::vector<unsigned> oldIntensiveQuantityStoreOwner_;
+    bool oldIntensiveQuantityStoreUpToDate_;
 };
 } // namespace Ewoms
 
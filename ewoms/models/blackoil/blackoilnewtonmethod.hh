@@ -34,6 +34,9 @@
 
 #include <opm/material/common/Unused.hpp>
 
+#include <numeric>
+#include <vector>
+
 namespace Ewoms {
 
 /*!
@@ -53,6 +56,7 @@ class BlackOilNewtonMethod : public GET_PROP_TYPE(TypeTag, DiscNewtonMethod)
     typedef typename GET_PROP_TYPE(TypeTag, Indices) Indices;
     typedef typename GET_PROP_TYPE(TypeTag, Scalar) Scalar;
     typedef typename GET_PROP_TYPE(TypeTag, Linearizer) Linearizer;
+    typedef typename GET_PROP_TYPE(TypeTag, ThreadManager) ThreadManager;
 
     static const unsigned numEq = GET_PROP_VALUE(TypeTag, NumEq);
 
@@ -75,6 +79,16 @@ public:
     unsigned numPriVarsSwitched() const
     { return numPriVarsSwitched_; }
 
+    /*!
+     * \copydoc NewtonMethod::updateIsThreadSafe
+     *
+     * The black-oil primary variables of a degree of freedom are switched without
+     * modifying any shared state except for the per-thread counters of the switched
+     * degrees of freedom.
+     */
+    static bool updateIsThreadSafe()
+    { return true; }
+
 protected:
     friend NewtonMethod<TypeTag>;
     friend ParentType;
@@ -94,18 +108,8 @@ protected:
     void endIteration_(SolutionVector& uCurrentIter,
                        const SolutionVector& uLastIter)
     {
-#if HAVE_MPI
-        // in the MPI enabled case we need to add up the number of DOF
-        // for which the interpretation changed over all processes.
-        int localSwitched = numPriVarsSwitched_;
-        MPI_Allreduce(&localSwitched,
-                      &numPriVarsSwitched_,
-                      /*num=*/1,
-                      MPI_INT,
-                      MPI_SUM,
-                      MPI_COMM_WORLD);
-#endif // HAVE_MPI
-
+        // note that the number of DOFs for which the interpretation changed has already
+        // been added up over all processes by update_()
         this->simulator_.model().newtonMethod().endIterMsg()
             << ", num switched=" << numPriVarsSwitched_;
 
@@ -120,6 +124,10 @@ public:
     {
         const auto& comm = this->simulator_.gridView().comm();
 
+        // the primary variables are updated concurrently, so every thread counts the
+        // switched DOFs separately
+        numPriVarsSwitchedPerThread_.assign(ThreadManager::maxThreads(), 0);
+
         int succeeded;
         try {
             ParentType::update_(nextSolution,
@@ -138,7 +146,10 @@ public:
         if (!succeeded)
             throw Opm::NumericalIssue("A process did not succeed in adapting the primary variables");
 
-        numPriVarsSwitched_ = comm.sum(numPriVarsSwitched_);
+        int localSwitched = std::accumulate(numPriVarsSwitchedPerThread_.begin(),
+                                            numPriVarsSwitchedPerThread_.end(),
+                                            0);
+        numPriVarsSwitched_ = comm.sum(localSwitched);
     }
 
 protected:
@@ -224,13 +235,14 @@ protected:
 
         // switch the new primary variables to something which is physically meaningful
         if (nextValue.adaptPrimaryVariables(this->problem(), globalDofIdx))
-            ++ numPriVarsSwitched_;
+            ++ numPriVarsSwitchedPerThread_[ThreadManager::threadId()];
 
         nextValue.checkDefined();
     }
 
 private:
     int numPriVarsSwitched_;
+    std::vector<int> numPriVarsSwitchedPerThread_;
 };
 } // namespace Ewoms
 
@@ -51,6 +51,8 @@
 
 #include <dune/common/fvector.hh>
 
+#include <algorithm>
+#include <cmath>
 #include <string>
 
 namespace Ewoms {
@@ -698,51 +700,57 @@ public:
         // Z = (1 + (P - 1) * M(v) ) / P
         // where M(v) is computed from user input
         // and P = viscosityMultiplier
+        //
+        // log(Z) is linearly interpolated in the logarithmic velocity space. Since the
+        // interpolation is piecewise linear, only the values at the sampling points
+        // which bracket the velocity of interest are required. These are computed on
+        // demand which avoids to allocate and fill a full table for each call.
         const std::vector<Scalar>& shearEffectRefMultiplier = plyshlogShearEffectRefMultiplier_[pvtnumRegionIdx];
-        size_t numTableEntries = shearEffectRefLogVelocity.size();
-        assert(shearEffectRefMultiplier.size() == numTableEntries);
-
-        std::vector<Scalar> shearEffectMultiplier(numTableEntries, 1.0);
-        for (size_t i = 0; i < numTableEntries; ++i) {
-            shearEffectMultiplier[i] = (1.0 + (viscosityMultiplier - 1.0)*shearEffectRefMultiplier[i]) / viscosityMultiplier;
-            shearEffectMultiplier[i] = Opm::log(shearEffectMultiplier[i]);
-        }
-        // store the logarithmic velocity and logarithmic multipliers in a table for easy look up and
-        // linear interpolation in the logarithmic space.
-        TabulatedFunction logShearEffectMultiplier = TabulatedFunction(numTableEntries, shearEffectRefLogVelocity, shearEffectMultiplier, /*bool sortInputs =*/ false );
+        assert(shearEffectRefMultiplier.size() == shearEffectRefLogVelocity.size());
+        assert(shearEffectRefLogVelocity.size() > 1);
 
         // Find sheared velocity (v) that satisfies
         // F = log(v) + log (Z) - log(v0) = 0;
-
-        // Set up the function
-        // u = log(v)
-        auto F = [&logShearEffectMultiplier, &v0AbsLog](const Evaluation& u) {
-            return u + logShearEffectMultiplier.eval(u, true) - v0AbsLog;
-        };
-        // and its derivative
-        auto dF = [&logShearEffectMultiplier](const Evaluation& u) {
-            return 1 + logShearEffectMultiplier.evalDerivative(u, true);
-        };
+        // where u = log(v)
+
+        // since F is piecewise linear, the solution can be found exactly once the
+        // segment of the table which contains it is known. use this as the initial value
+        // of the Newton method, so that it usually only needs to verify the result.
+        Scalar v0AbsLogValue = Opm::scalarValue(v0AbsLog);
+        size_t segIdx = shearSolutionSegmentIdx_(pvtnumRegionIdx, viscosityMultiplier, v0AbsLogValue);
+        Evaluation u = v0AbsLog;
+        {
+            Scalar x0 = shearEffectRefLogVelocity[segIdx];
+            Scalar logZ0 = logShearEffectMultiplier_(pvtnumRegionIdx, viscosityMultiplier, segIdx);
+            Scalar slope = logShearEffectMultiplierSlope_(pvtnumRegionIdx, viscosityMultiplier, segIdx);
+            if (std::abs(1 + slope) > eps)
+                u = x0 + (v0AbsLog - x0 - logZ0)/(1 + slope);
+        }
 
         // Solve F = 0 using Newton
-        // Use log(v0) as initial value for u
-        auto u = v0AbsLog;
+        Evaluation logZ = 0.0;
         bool converged = false;
         for (int i = 0; i < 20; ++i ) {
-            auto f = F(u);
-            auto df = dF(u);
-            u -= f/df;
+            segIdx = shearSegmentIdx_(pvtnumRegionIdx, Opm::scalarValue(u));
+            Scalar x0 = shearEffectRefLogVelocity[segIdx];
+            Scalar logZ0 = logShearEffectMultiplier_(pvtnumRegionIdx, viscosityMultiplier, segIdx);
+            Scalar slope = logShearEffectMultiplierSlope_(pvtnumRegionIdx, viscosityMultiplier, segIdx);
+
+            logZ = logZ0 + slope*(u - x0);
+            auto f = u + logZ - v0AbsLog;
+            auto df = 1 + slope;
             if (std::abs(Opm::scalarValue(f)) < 1e-12) {
                 converged = true;
                 break;
             }
+            u -= f/df;
         }
         if (!converged) {
             throw std::runtime_error("Not able to compute shear velocity. \n");
         }
 
         // return the shear factor
-        return Opm::exp( logShearEffectMultiplier.eval(u, /*extrapolate=*/true) );
+        return Opm::exp(logZ);
 
     }
 
@@ -750,6 +758,67 @@ public:
 
 
 private:
+    // returns the logarithm of the shear effect multiplier at a sampling point of the
+    // PLYSHLOG table for a given viscosity multiplier
+    static Scalar logShearEffectMultiplier_(unsigned pvtnumRegionIdx,
+                                            Scalar viscosityMultiplier,
+                                            size_t sampleIdx)
+    {
+        Scalar refMultiplier = plyshlogShearEffectRefMultiplier_[pvtnumRegionIdx][sampleIdx];
+        return std::log((1.0 + (viscosityMultiplier - 1.0)*refMultiplier) / viscosityMultiplier);
+    }
+
+    // returns the slope of the logarithmic shear effect multiplier w.r.t. the
+    // logarithmic velocity for a segment of the PLYSHLOG table
+    static Scalar logShearEffectMultiplierSlope_(unsigned pvtnumRegionIdx,
+                                                 Scalar viscosityMultiplier,
+                                                 size_t segIdx)
+    {
+        const auto& logVelocity = plyshlogShearEffectRefLogVelocity_[pvtnumRegionIdx];
+        Scalar logZ0 = logShearEffectMultiplier_(pvtnumRegionIdx, viscosityMultiplier, segIdx);
+        Scalar logZ1 = logShearEffectMultiplier_(pvtnumRegionIdx, viscosityMultiplier, segIdx + 1);
+        return (logZ1 - logZ0)/(logVelocity[segIdx + 1] - logVelocity[segIdx]);
+    }
+
+    // returns the index of the PLYSHLOG table segment which must be used to linearly
+    // interpolate (or extrapolate) at a given logarithmic velocity
+    static size_t shearSegmentIdx_(unsigned pvtnumRegionIdx, Scalar logVelocity)
+    {
+        const auto& x = plyshlogShearEffectRefLogVelocity_[pvtnumRegionIdx];
+        auto it = std::upper_bound(x.begin(), x.end(), logVelocity);
+        size_t idx = static_cast<size_t>(std::max<std::ptrdiff_t>(it - x.begin() - 1, 0));
+        return std::min(idx, x.size() - 2);
+    }
+
+    // returns the index of the PLYSHLOG table segment which contains the solution of
+    // the shear velocity equation, i.e., the segment in which the value of
+    // log(v) + log(Z(v)) crosses log(v0). this is determined by bisection over the
+    // sampling points, so only a logarithmic number of them needs to be evaluated.
+    static size_t shearSolutionSegmentIdx_(unsigned pvtnumRegionIdx,
+                                           Scalar viscosityMultiplier,
+                                           Scalar v0AbsLog)
+    {
+        const auto& x = plyshlogShearEffectRefLogVelocity_[pvtnumRegionIdx];
+        auto residual = [&](size_t sampleIdx) {
+            return x[sampleIdx]
+                + logShearEffectMultiplier_(pvtnumRegionIdx, viscosityMultiplier, sampleIdx)
+                - v0AbsLog;
+        };
+
+        size_t lowIdx = 0;
+        size_t highIdx = x.size() - 1;
+        if (residual(highIdx) <= 0.0)
+            return x.size() - 2;
+        while (highIdx - lowIdx > 1) {
+            size_t midIdx = (lowIdx + highIdx)/2;
+            if (residual(midIdx) <= 0.0)
+                lowIdx = midIdx;
+            else
+                highIdx = midIdx;
+        }
+        return lowIdx;
+    }
+
     static std::vector<Scalar> plyrockDeadPoreVolume_;
     static std::vector<Scalar> plyrockResidualResistanceFactor_;
     static std::vector<Scalar> plyrockRockDensityFactor_;
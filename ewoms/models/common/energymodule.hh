@@ -176,6 +176,7 @@ public:
     static void addFracturePhaseStorage(Dune::FieldVector<LhsEval, numEq>& storage OPM_UNUSED,
                                         const IntensiveQuantities& intQuants OPM_UNUSED,
                                         const Scv& scv OPM_UNUSED,
+                                        Scalar fractureVolume OPM_UNUSED,
                                         unsigned phaseIdx OPM_UNUSED)
     {}
 
@@ -386,6 +387,7 @@ public:
     static void addFracturePhaseStorage(Dune::FieldVector<LhsEval, numEq>& storage,
                                         const IntensiveQuantities& intQuants,
                                         const Scv& scv,
+                                        Scalar fractureVolume,
                                         unsigned phaseIdx)
     {
         const auto& fs = intQuants.fractureFluidState();
@@ -394,7 +396,7 @@ public:
             * Toolbox::template decay<LhsEval>(fs.internalEnergy(phaseIdx))
             * Toolbox::template decay<LhsEval>(fs.saturation(phaseIdx))
             * Toolbox::template decay<LhsEval>(intQuants.fracturePorosity())
-            * Toolbox::template decay<LhsEval>(intQuants.fractureVolume())/scv.volume();
+            * fractureVolume/scv.volume();
     }
 
     /*!
@@ -89,16 +89,13 @@ public:
         unsigned globalVertexIdx = elemCtx.globalSpaceIndex(vertexIdx, timeIdx);
 
         Opm::Valgrind::SetUndefined(fractureFluidState_);
-        Opm::Valgrind::SetUndefined(fractureVolume_);
         Opm::Valgrind::SetUndefined(fracturePorosity_);
         Opm::Valgrind::SetUndefined(fractureIntrinsicPermeability_);
         Opm::Valgrind::SetUndefined(fractureRelativePermeabilities_);
 
         // do nothing if there is no fracture within the current degree of freedom
-        if (!fractureMapper.isFractureVertex(globalVertexIdx)) {
-            fractureVolume_ = 0;
+        if (!fractureMapper.isFractureVertex(globalVertexIdx))
             return;
-        }
 
         // Make sure that the wetting saturation in the matrix fluid
         // state does not get larger than 1
@@ -114,35 +111,6 @@ public:
         fractureIntrinsicPermeability_ =
             problem.fractureIntrinsicPermeability(elemCtx, vertexIdx, timeIdx);
 
-        // compute the fracture volume for the current sub-control
-        // volume. note, that we don't take overlaps of fractures into
-        // account for this.
-        fractureVolume_ = 0;
-        const auto& vertexPos = elemCtx.pos(vertexIdx, timeIdx);
-        for (unsigned vertex2Idx = 0; vertex2Idx < elemCtx.numDof(/*timeIdx=*/0); ++ vertex2Idx) {
-            unsigned globalVertex2Idx = elemCtx.globalSpaceIndex(vertex2Idx, timeIdx);
-
-            if (vertexIdx == vertex2Idx ||
-                !fractureMapper.isFractureEdge(globalVertexIdx, globalVertex2Idx))
-                continue;
-
-            Scalar fractureWidth =
-                problem.fractureWidth(elemCtx, vertexIdx, vertex2Idx, timeIdx);
-
-            auto distVec = elemCtx.pos(vertex2Idx, timeIdx);
-            distVec -= vertexPos;
-
-            Scalar edgeLength = distVec.two_norm();
-
-            // the fracture is always adjacent to two sub-control
-            // volumes of the control volume, so when calculating the
-            // volume of the fracture which gets attributed to one
-            // SCV, the fracture width needs to divided by 2. Also,
-            // only half of the edge is located in the current control
-            // volume, so its length also needs to divided by 2.
-            fractureVolume_ += (fractureWidth / 2) * (edgeLength / 2);
-        }
-
         //////////
         // set the fluid state for the fracture.
         //////////
@@ -217,13 +185,6 @@ public:
     const DimMatrix& fractureIntrinsicPermeability() const
     { return fractureIntrinsicPermeability_; }
 
-    /*!
-     * \brief Return the volume [m^2] occupied by fractures within the
-     *        given sub-control volume.
-     */
-    Scalar fractureVolume() const
-    { return fractureVolume_; }
-
     /*!
      * \brief Returns a fluid state object which represents the
      *        thermodynamic state of the fluids within the fracture.
@@ -233,7 +194,6 @@ public:
 
 protected:
     FluidState fractureFluidState_;
-    Scalar fractureVolume_;
     Scalar fracturePorosity_;
     DimMatrix fractureIntrinsicPermeability_;
     Scalar fractureRelativePermeabilities_[numPhases];
@@ -86,9 +86,10 @@ public:
 
         const auto& intQuants = elemCtx.intensiveQuantities(dofIdx, timeIdx);
         const auto& scv = elemCtx.stencil(timeIdx).subControlVolume(dofIdx);
+        Scalar fractureVolume = problem.fractureVolume(elemCtx, dofIdx, timeIdx);
 
         // reduce the matrix storage by the fracture volume
-        phaseStorage *= 1 - intQuants.fractureVolume()/scv.volume();
+        phaseStorage *= 1 - fractureVolume/scv.volume();
 
         // add the storage term inside the fractures
         const auto& fsFracture = intQuants.fractureFluidState();
@@ -97,10 +98,10 @@ public:
             intQuants.fracturePorosity()*
             fsFracture.saturation(phaseIdx) *
             fsFracture.density(phaseIdx) *
-            intQuants.fractureVolume()/scv.volume();
+            fractureVolume/scv.volume();
 
         EnergyModule::addFracturePhaseStorage(phaseStorage, intQuants, scv,
-                                              phaseIdx);
+                                              fractureVolume, phaseIdx);
 
         // add the result to the overall storage term
         storage += phaseStorage;
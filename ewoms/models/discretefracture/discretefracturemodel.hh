@@ -83,13 +83,6 @@ SET_TYPE_PROP(DiscreteFractureModel, ExtensiveQuantities,
 //! will converge very poorly
 SET_BOOL_PROP(DiscreteFractureModel, UseTwoPointGradients, true);
 
-// The intensive quantity cache cannot be used by the discrete fracture model, because
-// the intensive quantities of a control degree of freedom are not identical to the
-// intensive quantities of the other intensive quantities of the same of the same degree
-// of freedom. This is because the fracture properties (volume, permeability, etc) are
-// specific for each...
-SET_BOOL_PROP(DiscreteFractureModel, EnableIntensiveQuantityCache, false);
-
 END_PROPERTIES
 
 namespace Ewoms {
@@ -120,12 +113,7 @@ class DiscreteFractureModel : public ImmiscibleModel<TypeTag>
 public:
     DiscreteFractureModel(Simulator& simulator)
         : ParentType(simulator)
-    {
-        if (EWOMS_GET_PARAM(TypeTag, bool, EnableIntensiveQuantityCache)) {
-            throw std::runtime_error("The discrete fracture model does not work in conjunction "
-                                     "with intensive quantities caching");
-        }
-    }
+    {}
 
     /*!
      * \brief Register all run-time parameters for the immiscible model.
@@ -135,6 +135,61 @@ public:
         throw std::logic_error("Not implemented: Problem::fracturePorosity()");
     }
 
+    /*!
+     * \brief Returns the volume [m^2] occupied by fractures within a given sub-control
+     *        volume.
+     *
+     * In contrast to the remaining fracture properties, this quantity is specific for
+     * the element which the sub-control volume belongs to. It thus cannot be a part of
+     * the intensive quantities of the degree of freedom.
+     *
+     * \param context Reference to the object which represents the
+     *                current execution context.
+     * \param spaceIdx The local index of spatial entity defined by the context
+     * \param timeIdx The index used by the time discretization.
+     */
+    template <class Context>
+    Scalar fractureVolume(const Context& context,
+                          unsigned spaceIdx,
+                          unsigned timeIdx) const
+    {
+        const auto& fractureMapper = asImp_().fractureMapper();
+        unsigned globalIdx = context.globalSpaceIndex(spaceIdx, timeIdx);
+
+        // do nothing if there is no fracture within the current degree of freedom
+        if (!fractureMapper.isFractureVertex(globalIdx))
+            return 0.0;
+
+        // note, that we don't take overlaps of fractures into account for this.
+        Scalar result = 0.0;
+        const auto& vertexPos = context.pos(spaceIdx, timeIdx);
+        for (unsigned space2Idx = 0; space2Idx < context.numDof(/*timeIdx=*/0); ++ space2Idx) {
+            unsigned global2Idx = context.globalSpaceIndex(space2Idx, timeIdx);
+
+            if (spaceIdx == space2Idx ||
+                !fractureMapper.isFractureEdge(globalIdx, global2Idx))
+                continue;
+
+            Scalar fractureWidth =
+                asImp_().fractureWidth(context, spaceIdx, space2Idx, timeIdx);
+
+            auto distVec = context.pos(space2Idx, timeIdx);
+            distVec -= vertexPos;
+
+            Scalar edgeLength = distVec.two_norm();
+
+            // the fracture is always adjacent to two sub-control
+            // volumes of the control volume, so when calculating the
+            // volume of the fracture which gets attributed to one
+            // SCV, the fracture width needs to divided by 2. Also,
+            // only half of the edge is located in the current control
+            // volume, so its length also needs to divided by 2.
+            result += (fractureWidth / 2) * (edgeLength / 2);
+        }
+
+        return result;
+    }
+
 private:
     //! Returns the implementation of the problem (i.e. static polymorphism)
     Implementation& asImp_()
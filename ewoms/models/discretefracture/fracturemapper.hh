@@ -30,39 +30,33 @@
 #include <ewoms/common/propertysystem.hh>
 
 #include <algorithm>
-#include <set>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace Ewoms {
 
 /*!
  * \ingroup DiscreteFractureModel
  * \brief Stores the topology of fractures.
+ *
+ * After all fracture edges have been added, finalize() must be called. This converts the
+ * fracture topology into flat data structures, i.e., a bitmap for the fracture vertices
+ * and a sorted adjacency list of the fracture neighbors of each vertex. Queries thus do
+ * not need to walk any tree structures. Querying the fracture topology before it has
+ * been finalized results in an exception.
  */
 template <class TypeTag>
 class FractureMapper
 {
-    struct FractureEdge
-    {
-        FractureEdge(unsigned edgeVertex1Idx, unsigned edgeVertex2Idx)
-            : i_(std::min(edgeVertex1Idx, edgeVertex2Idx)),
-              j_(std::max(edgeVertex1Idx, edgeVertex2Idx))
-        {}
-
-        bool operator<(const FractureEdge& e) const
-        { return i_ < e.i_ || (i_ == e.i_ && j_ < e.j_); }
-
-        bool operator==(const FractureEdge& e) const
-        { return i_ == e.i_ && j_ == e.j_; }
-
-        unsigned i_;
-        unsigned j_;
-    };
+    typedef std::pair<unsigned, unsigned> FractureEdge;
 
 public:
     /*!
      * \brief Constructor
      */
     FractureMapper()
+        : finalized_(true)
     {}
 
     /*!
@@ -73,9 +67,55 @@ public:
      */
     void addFractureEdge(unsigned vertexIdx1, unsigned vertexIdx2)
     {
-        fractureEdges_.insert(FractureEdge(vertexIdx1, vertexIdx2));
-        fractureVertices_.insert(vertexIdx1);
-        fractureVertices_.insert(vertexIdx2);
+        pendingEdges_.emplace_back(vertexIdx1, vertexIdx2);
+        finalized_ = false;
+    }
+
+    /*!
+     * \brief Convert the fracture edges which were added so far into the data
+     *        structures used for the queries.
+     *
+     * This method must be called after the last fracture edge has been added and before
+     * the fracture topology is queried. The queries throw std::logic_error otherwise.
+     */
+    void finalize()
+    {
+        // collect all edges in both directions. duplicate edges are removed below.
+        std::vector<FractureEdge> directedEdges;
+        directedEdges.reserve(2*(pendingEdges_.size() + fractureNeighbors_.size()/2));
+        for (unsigned vertexIdx = 0; vertexIdx + 1 < fractureNeighborOffsets_.size(); ++vertexIdx)
+            for (unsigned i = fractureNeighborOffsets_[vertexIdx];
+                 i < fractureNeighborOffsets_[vertexIdx + 1];
+                 ++i)
+                directedEdges.emplace_back(vertexIdx, fractureNeighbors_[i]);
+        for (const auto& edge : pendingEdges_) {
+            directedEdges.emplace_back(edge.first, edge.second);
+            directedEdges.emplace_back(edge.second, edge.first);
+        }
+        pendingEdges_.clear();
+
+        std::sort(directedEdges.begin(), directedEdges.end());
+        directedEdges.erase(std::unique(directedEdges.begin(), directedEdges.end()),
+                            directedEdges.end());
+
+        unsigned numVertices = 0;
+        if (!directedEdges.empty())
+            numVertices = directedEdges.back().first + 1;
+
+        // create the vertex bitmap and the adjacency list in compressed row format
+        isFractureVertex_.assign(numVertices, false);
+        fractureNeighborOffsets_.assign(numVertices + 1, 0);
+        fractureNeighbors_.resize(directedEdges.size());
+        for (unsigned i = 0; i < directedEdges.size(); ++i) {
+            const auto& edge = directedEdges[i];
+            isFractureVertex_[edge.first] = true;
+            ++fractureNeighborOffsets_[edge.first + 1];
+            fractureNeighbors_[i] = edge.second;
+        }
+        for (unsigned vertexIdx = 0; vertexIdx < numVertices; ++vertexIdx)
+            fractureNeighborOffsets_[vertexIdx + 1] += fractureNeighborOffsets_[vertexIdx];
+
+        finalized_ = true;
     }
 
     /*!
@@ -84,7 +124,13 @@ public:
      * \param vertexIdx The index of the vertex.
      */
     bool isFractureVertex(unsigned vertexIdx) const
-    { return fractureVertices_.count(vertexIdx) > 0; }
+    {
+        if (!finalized_)
+            throw std::logic_error("FractureMapper::finalize() must be called after the last "
+                                   "fracture edge has been added");
+
+        return vertexIdx < isFractureVertex_.size() && isFractureVertex_[vertexIdx];
+    }
 
     /*!
      * \brief Returns true iff a fracture is associated with a given edge.
@@ -94,13 +140,21 @@ public:
      */
     bool isFractureEdge(unsigned vertex1Idx, unsigned vertex2Idx) const
     {
-        FractureEdge tmp(vertex1Idx, vertex2Idx);
-        return fractureEdges_.count(tmp) > 0;
+        if (!isFractureVertex(vertex1Idx))
+            return false;
+
+        auto beginIt = fractureNeighbors_.begin() + fractureNeighborOffsets_[vertex1Idx];
+        auto endIt = fractureNeighbors_.begin() + fractureNeighborOffsets_[vertex1Idx + 1];
+        return std::binary_search(beginIt, endIt, vertex2Idx);
     }
 
 private:
-    std::set<FractureEdge> fractureEdges_;
-    std::set<unsigned> fractureVertices_;
+    std::vector<FractureEdge> pendingEdges_;
+    bool finalized_;
+
+    std::vector<bool> isFractureVertex_;
+    std::vector<unsigned> fractureNeighborOffsets_;
+    std::vector<unsigned> fractureNeighbors_;
 };
 
 } // namespace Ewoms
@@ -36,10 +36,14 @@
 
 #include <opm/material/fluidstates/CompositionalFluidState.hpp>
 #include <opm/material/common/Valgrind.hpp>
+#include <opm/material/common/Exceptions.hpp>
 
 #include <dune/common/fvector.hh>
 #include <dune/common/fmatrix.hh>
 
+#include <algorithm>
+#include <cmath>
+
 namespace Ewoms {
 
 /*!
@@ -64,6 +68,7 @@ class FlashIntensiveQuantities
     typedef typename GET_PROP_TYPE(TypeTag, FluxModule) FluxModule;
     typedef typename GET_PROP_TYPE(TypeTag, GridView) GridView;
     typedef typename GET_PROP_TYPE(TypeTag, ThreadManager) ThreadManager;
+    typedef typename GET_PROP_TYPE(TypeTag, Model) Model;
 
     // primary variable indices
     enum { cTot0Idx = Indices::cTot0Idx };
@@ -106,13 +111,21 @@ public:
 
         const auto& priVars = elemCtx.primaryVars(dofIdx, timeIdx);
         const auto& problem = elemCtx.problem();
-        Scalar flashTolerance = EWOMS_GET_PARAM(TypeTag, Scalar, FlashTolerance);
+        const auto& model = elemCtx.model();
+        Scalar flashTolerance = model.flashTolerance();
+        unsigned globalDofIdx = elemCtx.globalSpaceIndex(dofIdx, timeIdx);
 
         // extract the total molar densities of the components
         ComponentVector cTotal;
         for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
             cTotal[compIdx] = priVars.makeEvaluation(cTot0Idx + compIdx, timeIdx);
 
+        // determine the initial values of the flash solver. if available, we use a full
+        // thermodynamic hint, else the result of the flash calculation for the degree of
+        // freedom of the previous Newton iterate and only if both are not available, we
+        // start from scratch.
+        bool warmStarted = true;
+        typename Model::FlashState flashState;
         const auto *hint = elemCtx.thermodynamicHint(dofIdx, timeIdx);
         if (hint) {
             // use the same fluid state as the one of the hint, but
@@ -122,18 +135,62 @@ public:
             fluidState_.assign(hint->fluidState());
             fluidState_.setTemperature(T);
         }
-        else
+        else if (timeIdx == 0 && model.loadFlashState(flashState, globalDofIdx))
+            assignFlashState_(flashState);
+        else {
             FlashSolver::guessInitial(fluidState_, cTotal);
+            warmStarted = false;
+        }
 
-        // compute the phase compositions, densities and pressures
+        // compute the phase compositions, densities and pressures. if the initial values
+        // only exhibit a single phase and this phase is still stable for the current
+        // total concentrations, the flash calculation can be skipped.
         typename FluidSystem::template ParameterCache<Evaluation> paramCache;
         const MaterialLawParams& materialParams =
             problem.materialLawParams(elemCtx, dofIdx, timeIdx);
-        FlashSolver::template solve<MaterialLaw>(fluidState_,
-                                                 materialParams,
-                                                 paramCache,
-                                                 cTotal,
-                                                 flashTolerance);
+        bool skipFlash = false;
+        if (warmStarted) {
+            FluidState initialFluidState(fluidState_);
+            skipFlash = updateSinglePhase_(paramCache, materialParams, cTotal);
+            if (!skipFlash)
+                fluidState_ = initialFluidState;
+        }
+
+        if (skipFlash)
+            model.recordSkippedFlashSolve();
+        else {
+            bool restarted = false;
+            try {
+                FlashSolver::template solve<MaterialLaw>(fluidState_,
+                                                         materialParams,
+                                                         paramCache,
+                                                         cTotal,
+                                                         flashTolerance);
+            }
+            catch (const Opm::NumericalIssue&) {
+                if (!warmStarted)
+                    throw;
+
+                // the initial values were too far away from the solution. try again
+                // from scratch.
+                restarted = true;
+                FlashSolver::guessInitial(fluidState_, cTotal);
+                FlashSolver::template solve<MaterialLaw>(fluidState_,
+                                                         materialParams,
+                                                         paramCache,
+                                                         cTotal,
+                                                         flashTolerance);
+            }
+            model.recordFlashSolve(warmStarted, restarted);
+        }
+
+        // remember the result to warm-start the flash calculation for the degree of
+        // freedom in the next Newton iteration. results for perturbed primary variables
+        // (e.g., if the Jacobian is approximated by finite differences) are not stored.
+        if (timeIdx == 0 && priVars == model.solution(timeIdx)[globalDofIdx]) {
+            extractFlashState_(flashState);
+            model.storeFlashState(flashState, globalDofIdx);
+        }
 
         // calculate relative permeabilities
         MaterialLaw::relativePermeabilities(relativePermeability_,
@@ -205,6 +262,170 @@ public:
     { return porosity_; }
 
 private:
+    /*!
+     * \brief Try to compute the fluid state without calling the flash solver.
+     *
+     * This only works if exactly one phase is present in the initial values of the
+     * fluid state. In this case, the composition of this phase is given by the total
+     * concentrations and its pressure is determined so that its molar density matches
+     * their sum. The phase is considered to be stable if the mole fractions of all
+     * other phases which are in equilibrium with it sum up to less than one. Else,
+     * false is returned and the fluid state must be determined by the flash solver. In
+     * this case, the fluid state is left in an undefined state.
+     */
+    template <class ParameterCache>
+    bool updateSinglePhase_(ParameterCache& paramCache,
+                            const MaterialLawParams& materialParams,
+                            const ComponentVector& cTotal)
+    {
+        // the maximum saturation of a phase which is considered to be absent
+        static const Scalar absentSaturation = 1e-10;
+        // the maximum sum of the mole fractions of an absent phase
+        static const Scalar maxAbsentMoleFractionSum = 1.0 - 1e-4;
+        static const unsigned maxPressureIterations = 20;
+        static const Scalar pressureTolerance = 1e-10;
+
+        if (numPhases < 2)
+            return false;
+
+        unsigned refPhaseIdx = numPhases;
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            if (Opm::scalarValue(fluidState_.saturation(phaseIdx)) <= absentSaturation)
+                continue;
+            else if (refPhaseIdx < numPhases)
+                // more than one phase is present
+                return false;
+            refPhaseIdx = phaseIdx;
+        }
+        if (refPhaseIdx == numPhases)
+            return false;
+
+        // the composition of the present phase is given by the total concentrations
+        Evaluation cSum = 0.0;
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            cSum += cTotal[compIdx];
+        if (Opm::scalarValue(cSum) <= 0.0)
+            return false;
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            fluidState_.setSaturation(phaseIdx, (phaseIdx == refPhaseIdx) ? 1.0 : 0.0);
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+            fluidState_.setMoleFraction(refPhaseIdx, compIdx, cTotal[compIdx]/cSum);
+
+        // the differences between the phase pressures only depend on the saturations
+        Evaluation pc[numPhases];
+        MaterialLaw::capillaryPressures(pc, materialParams, fluidState_);
+
+        // determine the pressure of the present phase using a Newton method. the
+        // derivative of the molar density with regard to pressure is approximated by a
+        // finite difference.
+        Evaluation p(Opm::scalarValue(fluidState_.pressure(refPhaseIdx)));
+        bool converged = false;
+        for (unsigned iterIdx = 0; iterIdx < maxPressureIterations; ++iterIdx) {
+            Evaluation f = refPhaseMolarDensity_(paramCache, refPhaseIdx, p) - cSum;
+
+            Scalar pScalar = Opm::scalarValue(p);
+            Scalar eps = 1e-7*std::max<Scalar>(1.0, std::abs(pScalar));
+            Scalar fEps =
+                Opm::scalarValue(refPhaseMolarDensity_(paramCache, refPhaseIdx, Evaluation(pScalar + eps)))
+                - Opm::scalarValue(cSum);
+            Scalar dfdp = (fEps - Opm::scalarValue(f))/eps;
+            if (!std::isfinite(dfdp) || dfdp <= 0.0)
+                return false;
+
+            Evaluation delta = f/dfdp;
+            p -= delta;
+            if (!std::isfinite(Opm::scalarValue(p)) || Opm::scalarValue(p) <= 0.0)
+                return false;
+
+            if (std::abs(Opm::scalarValue(delta)) <= pressureTolerance*std::abs(Opm::scalarValue(p))) {
+                converged = true;
+                break;
+            }
+        }
+        if (!converged)
+            return false;
+
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx)
+            fluidState_.setPressure(phaseIdx, p + (pc[phaseIdx] - pc[refPhaseIdx]));
+
+        // compute the fugacities of the components in the present phase
+        paramCache.updatePhase(fluidState_, refPhaseIdx);
+        fluidState_.setDensity(refPhaseIdx,
+                               FluidSystem::density(fluidState_, paramCache, refPhaseIdx));
+        Evaluation fugacity[numComponents];
+        for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+            const Evaluation& phi =
+                FluidSystem::fugacityCoefficient(fluidState_, paramCache, refPhaseIdx, compIdx);
+            fluidState_.setFugacityCoefficient(refPhaseIdx, compIdx, phi);
+            fugacity[compIdx] = phi*fluidState_.moleFraction(refPhaseIdx, compIdx)*fluidState_.pressure(refPhaseIdx);
+        }
+
+        // the absent phases are in equilibrium with the present one. the fugacity
+        // coefficients are evaluated using the compositions of the initial values.
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            if (phaseIdx == refPhaseIdx)
+                continue;
+
+            paramCache.updatePhase(fluidState_, phaseIdx);
+            Evaluation phi[numComponents];
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                phi[compIdx] = FluidSystem::fugacityCoefficient(fluidState_, paramCache, phaseIdx, compIdx);
+
+            Scalar sumx = 0.0;
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx) {
+                const Evaluation& x = fugacity[compIdx]/(phi[compIdx]*fluidState_.pressure(phaseIdx));
+                fluidState_.setMoleFraction(phaseIdx, compIdx, x);
+                fluidState_.setFugacityCoefficient(phaseIdx, compIdx, phi[compIdx]);
+                sumx += Opm::scalarValue(x);
+            }
+
+            if (!std::isfinite(sumx) || sumx >= maxAbsentMoleFractionSum)
+                // the phase would appear
+                return false;
+
+            paramCache.updatePhase(fluidState_, phaseIdx);
+            fluidState_.setDensity(phaseIdx, FluidSystem::density(fluidState_, paramCache, phaseIdx));
+        }
+
+        paramCache.updateAll(fluidState_);
+        return true;
+    }
+
+    template <class ParameterCache>
+    Evaluation refPhaseMolarDensity_(ParameterCache& paramCache,
+                                     unsigned refPhaseIdx,
+                                     const Evaluation& p)
+    {
+        fluidState_.setPressure(refPhaseIdx, p);
+        paramCache.updatePhase(fluidState_, refPhaseIdx);
+        const Evaluation& rho = FluidSystem::density(fluidState_, paramCache, refPhaseIdx);
+        return rho/fluidState_.averageMolarMass(refPhaseIdx);
+    }
+
+    template <class FlashState>
+    void assignFlashState_(const FlashState& flashState)
+    {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            fluidState_.setPressure(phaseIdx, flashState.pressure[phaseIdx]);
+            fluidState_.setSaturation(phaseIdx, flashState.saturation[phaseIdx]);
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                fluidState_.setMoleFraction(phaseIdx, compIdx, flashState.moleFraction[phaseIdx][compIdx]);
+        }
+    }
+
+    template <class FlashState>
+    void extractFlashState_(FlashState& flashState) const
+    {
+        for (unsigned phaseIdx = 0; phaseIdx < numPhases; ++phaseIdx) {
+            flashState.pressure[phaseIdx] = Opm::scalarValue(fluidState_.pressure(phaseIdx));
+            flashState.saturation[phaseIdx] = Opm::scalarValue(fluidState_.saturation(phaseIdx));
+            for (unsigned compIdx = 0; compIdx < numComponents; ++compIdx)
+                flashState.moleFraction[phaseIdx][compIdx] =
+                    Opm::scalarValue(fluidState_.moleFraction(phaseIdx, compIdx));
+        }
+    }
+
     DimMatrix intrinsicPerm_;
     FluidState fluidState_;
     Evaluation porosity_;
@@ -38,6 +38,7 @@
 #include "flashintensivequantities.hh"
 #include "flashextensivequantities.hh"
 #include "flashindices.hh"
+#include "flashnewtonmethod.hh"
 
 #include <ewoms/models/common/multiphasebasemodel.hh>
 #include <ewoms/models/common/energymodule.hh>
@@ -48,8 +49,11 @@
 #include <opm/material/fluidmatrixinteractions/MaterialTraits.hpp>
 #include <opm/material/constraintsolvers/NcpFlash.hpp>
 
+#include <atomic>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <vector>
 
 namespace Ewoms {
 template <class TypeTag>
@@ -79,6 +83,9 @@ SET_SCALAR_PROP(FlashModel, FlashTolerance, -1.0);
 //! the Model property
 SET_TYPE_PROP(FlashModel, Model, Ewoms::FlashModel<TypeTag>);
 
+//! Use the Newton method which reports the statistics of the flash calculations
+SET_TYPE_PROP(FlashModel, NewtonMethod, Ewoms::FlashNewtonMethod<TypeTag>);
+
 //! the PrimaryVariables property
 SET_TYPE_PROP(FlashModel, PrimaryVariables, Ewoms::FlashPrimaryVariables<TypeTag>);
 
@@ -186,6 +193,7 @@ class FlashModel
 
     typedef typename GET_PROP_TYPE(TypeTag, Indices) Indices;
 
+    enum { numPhases = GET_PROP_VALUE(TypeTag, NumPhases) };
     enum { numComponents = GET_PROP_VALUE(TypeTag, NumComponents) };
     enum { enableDiffusion = GET_PROP_VALUE(TypeTag, EnableDiffusion) };
     enum { enableEnergy = GET_PROP_VALUE(TypeTag, EnableEnergy) };
@@ -193,10 +201,28 @@ class FlashModel
 
     typedef Ewoms::EnergyModule<TypeTag, enableEnergy> EnergyModule;
 
+    // the states of the entries of the flash state stores
+    enum { flashStateEmpty = 0, flashStateValid = 1, flashStateBusy = 2 };
+
 public:
+    /*!
+     * \brief The part of the result of a flash calculation which is required to
+     *        warm-start the flash solver for the same degree of freedom.
+     */
+    struct FlashState
+    {
+        Scalar pressure[numPhases];
+        Scalar saturation[numPhases];
+        Scalar moleFraction[numPhases][numComponents];
+    };
+
     FlashModel(Simulator& simulator)
         : ParentType(simulator)
-    {}
+    {
+        flashTolerance_ = EWOMS_GET_PARAM(TypeTag, Scalar, FlashTolerance);
+        readFlashStateIdx_ = 0;
+        resetFlashStatistics();
+    }
 
     /*!
      * \brief Register all run-time parameters for the immiscible model.
@@ -300,6 +326,161 @@ public:
         return FluidSystem::molarMass(compIdx);
     }
 
+    /*!
+     * \copydoc FvBaseDiscretization::finishInit()
+     */
+    void finishInit()
+    {
+        ParentType::finishInit();
+
+        resizeFlashStates_();
+    }
+
+    void adaptGrid()
+    {
+        ParentType::adaptGrid();
+
+        resizeFlashStates_();
+    }
+
+    /*!
+     * \brief Returns the maximum tolerance of the flash solver.
+     *
+     * A negative value means that the flash solver chooses its tolerance itself.
+     */
+    Scalar flashTolerance() const
+    { return flashTolerance_; }
+
+    /*!
+     * \brief Retrieve the result of the flash calculation for a degree of freedom
+     *        which was done for the previous Newton iterate.
+     *
+     * The store which is read by this method is not modified until the next call of
+     * swapFlashStates(), so the result only depends on the previous iterate and not on
+     * the order in which the degrees of freedom are visited by the threads. This
+     * method returns false if no result is available.
+     *
+     * \param state The object which receives the stored state
+     * \param globalDofIdx The global index of the degree of freedom of interest
+     */
+    bool loadFlashState(FlashState& state, unsigned globalDofIdx) const
+    {
+        const auto& status = flashStateStatus_[readFlashStateIdx_];
+        if (globalDofIdx >= flashStates_[readFlashStateIdx_].size()
+            || status[globalDofIdx].load(std::memory_order_relaxed) != flashStateValid)
+            return false;
+
+        state = flashStates_[readFlashStateIdx_][globalDofIdx];
+        return true;
+    }
+
+    /*!
+     * \brief Store the result of a flash calculation for the current Newton iterate.
+     *
+     * This method may be called concurrently by multiple threads. Only the first
+     * result which is stored for a given degree of freedom is kept. Since the flash
+     * calculations for the same primary variables are started from the same initial
+     * values, all results for a degree of freedom are identical.
+     *
+     * \param state The result of the flash calculation
+     * \param globalDofIdx The global index of the degree of freedom of interest
+     */
+    void storeFlashState(const FlashState& state, unsigned globalDofIdx) const
+    {
+        unsigned writeIdx = 1 - readFlashStateIdx_;
+        if (globalDofIdx >= flashStates_[writeIdx].size())
+            return;
+
+        auto& status = flashStateStatus_[writeIdx][globalDofIdx];
+        unsigned char expected = flashStateEmpty;
+        if (!status.compare_exchange_strong(expected,
+                                            flashStateBusy,
+                                            std::memory_order_acquire))
+            return;
+
+        flashStates_[writeIdx][globalDofIdx] = state;
+        status.store(flashStateValid, std::memory_order_release);
+    }
+
+    /*!
+     * \brief Make the flash results of the current Newton iterate available for
+     *        warm-starting the flash calculations of the next one.
+     *
+     * This must not be called from within a threaded region.
+     */
+    void swapFlashStates()
+    {
+        readFlashStateIdx_ = 1 - readFlashStateIdx_;
+
+        auto& status = flashStateStatus_[1 - readFlashStateIdx_];
+        size_t numDof = flashStates_[1 - readFlashStateIdx_].size();
+        for (size_t dofIdx = 0; dofIdx < numDof; ++dofIdx)
+            status[dofIdx].store(flashStateEmpty, std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief Account for a flash calculation.
+     *
+     * \param warmStarted Specifies whether the solver was started from a previous result
+     * \param restarted Specifies whether the solver needed to be restarted from scratch
+     *                  because it failed to converge from the initial values
+     */
+    void recordFlashSolve(bool warmStarted, bool restarted) const
+    {
+        numFlashSolves_.fetch_add(1, std::memory_order_relaxed);
+        if (warmStarted)
+            numWarmStartedFlashSolves_.fetch_add(1, std::memory_order_relaxed);
+        if (restarted)
+            numFlashRestarts_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief Account for a degree of freedom for which the flash calculation was
+     *        skipped because it stays single-phase.
+     */
+    void recordSkippedFlashSolve() const
+    { numSkippedFlashSolves_.fetch_add(1, std::memory_order_relaxed); }
+
+    /*!
+     * \brief Reset the counters of the flash calculations.
+     *
+     * This must not be called from within a threaded region.
+     */
+    void resetFlashStatistics()
+    {
+        numFlashSolves_ = 0;
+        numWarmStartedFlashSolves_ = 0;
+        numFlashRestarts_ = 0;
+        numSkippedFlashSolves_ = 0;
+    }
+
+    /*!
+     * \brief Returns the number of flash calculations since the counters were reset.
+     */
+    unsigned long numFlashSolves() const
+    { return numFlashSolves_; }
+
+    /*!
+     * \brief Returns the number of flash calculations since the counters were reset
+     *        which were started from the result of a previous calculation.
+     */
+    unsigned long numWarmStartedFlashSolves() const
+    { return numWarmStartedFlashSolves_; }
+
+    /*!
+     * \brief Returns the number of flash calculations since the counters were reset
+     *        which needed to be restarted from scratch.
+     */
+    unsigned long numFlashRestarts() const
+    { return numFlashRestarts_; }
+
+    /*!
+     * \brief Returns the number of flash calculations since the counters were reset
+     *        which were skipped because the degree of freedom stayed single-phase.
+     */
+    unsigned long numSkippedFlashSolves() const
+    { return numSkippedFlashSolves_; }
+
     void registerOutputModules_()
     {
         ParentType::registerOutputModules_();
@@ -311,6 +492,32 @@ public:
         if (enableEnergy)
             this->addOutputModule(new Ewoms::VtkEnergyModule<TypeTag>(this->simulator_));
     }
+
+private:
+    void resizeFlashStates_()
+    {
+        size_t numDof = this->numGridDof();
+        for (unsigned storeIdx = 0; storeIdx < 2; ++storeIdx) {
+            flashStates_[storeIdx].resize(numDof);
+            flashStateStatus_[storeIdx].reset(new std::atomic<unsigned char>[numDof]);
+            for (size_t dofIdx = 0; dofIdx < numDof; ++dofIdx)
+                flashStateStatus_[storeIdx][dofIdx].store(flashStateEmpty, std::memory_order_relaxed);
+        }
+    }
+
+    Scalar flashTolerance_;
+
+    // the flash results of the previous Newton iterate are read from the store with
+    // the index readFlashStateIdx_, the ones of the current iterate are written to the
+    // other one.
+    unsigned readFlashStateIdx_;
+    mutable std::vector<FlashState> flashStates_[2];
+    mutable std::unique_ptr<std::atomic<unsigned char>[]> flashStateStatus_[2];
+
+    mutable std::atomic<unsigned long> numFlashSolves_;
+    mutable std::atomic<unsigned long> numWarmStartedFlashSolves_;
+    mutable std::atomic<unsigned long> numFlashRestarts_;
+    mutable std::atomic<unsigned long> numSkippedFlashSolves_;
 };
 
 } // namespace Ewoms
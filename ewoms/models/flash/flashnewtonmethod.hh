@@ -0,0 +1,102 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \copydoc Ewoms::FlashNewtonMethod
+ */
+#ifndef EWOMS_FLASH_NEWTON_METHOD_HH
+#define EWOMS_FLASH_NEWTON_METHOD_HH
+
+#include "flashproperties.hh"
+
+namespace Ewoms {
+
+/*!
+ * \ingroup FlashModel
+ *
+ * \brief A Newton solver specific to the flash-based compositional model.
+ *
+ * In addition to the standard Newton-Raphson method, this class makes the results of
+ * the flash calculations of the previous iterate available as initial values for the
+ * current one and reports the statistics of the flash calculations which were
+ * required by each iteration.
+ */
+template <class TypeTag>
+class FlashNewtonMethod : public GET_PROP_TYPE(TypeTag, DiscNewtonMethod)
+{
+    typedef typename GET_PROP_TYPE(TypeTag, DiscNewtonMethod) ParentType;
+
+    typedef typename GET_PROP_TYPE(TypeTag, Simulator) Simulator;
+    typedef typename GET_PROP_TYPE(TypeTag, SolutionVector) SolutionVector;
+
+public:
+    FlashNewtonMethod(Simulator& simulator) : ParentType(simulator)
+    {}
+
+protected:
+    friend ParentType;
+    friend NewtonMethod<TypeTag>;
+
+    /*!
+     * \copydoc NewtonMethod::beginIteration_
+     */
+    void beginIteration_()
+    {
+        this->model_().swapFlashStates();
+        this->model_().resetFlashStatistics();
+        ParentType::beginIteration_();
+    }
+
+    /*!
+     * \copydoc FvBaseNewtonMethod::endIteration_
+     */
+    void endIteration_(SolutionVector& uCurrentIter,
+                       const SolutionVector& uLastIter)
+    {
+        // the statistics are only printed by the first rank, but all ranks must take
+        // part in the reduction
+        if (EWOMS_GET_PARAM(TypeTag, bool, NewtonVerbose)) {
+            const auto& model = this->model_();
+            unsigned long counts[4] = {
+                model.numFlashSolves(),
+                model.numWarmStartedFlashSolves(),
+                model.numFlashRestarts(),
+                model.numSkippedFlashSolves()
+            };
+            this->simulator_.gridView().comm().sum(counts, 4);
+
+            this->endIterMsg()
+                << ", flash solves=" << counts[0]
+                << " (warm-started=" << counts[1]
+                << ", restarted=" << counts[2]
+                << ", skipped=" << counts[3] << ")";
+        }
+
+        ParentType::endIteration_(uCurrentIter, uLastIter);
+    }
+};
+
+} // namespace Ewoms
+
+#endif
@@ -46,12 +46,15 @@
 #include <ewoms/io/vtkcompositionmodule.hh>
 #include <ewoms/io/vtkenergymodule.hh>
 #include <ewoms/io/vtkdiffusionmodule.hh>
+#include <ewoms/parallel/threadedentityiterator.hh>
 
 #include <opm/material/fluidmatrixinteractions/NullMaterial.hpp>
 #include <opm/material/fluidmatrixinteractions/MaterialTraits.hpp>
 #include <opm/material/common/Exceptions.hpp>
 
+#include <atomic>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -465,59 +468,40 @@ public:
     {
         numSwitched_ = 0;
 
-        int succeeded;
-        try {
-            std::vector<bool> visited(this->numGridDof(), false);
+        // the switching is done by a threaded pass over the elements. since a degree of
+        // freedom may be shared by multiple elements, each one is claimed by the first
+        // thread which encounters it.
+        size_t numGridDof = this->numGridDof();
+        std::unique_ptr<std::atomic<bool>[]> visited(new std::atomic<bool>[numGridDof]);
+        for (size_t dofIdx = 0; dofIdx < numGridDof; ++dofIdx)
+            visited[dofIdx].store(false, std::memory_order_relaxed);
+
+        int succeeded = 1;
+        unsigned numSwitched = 0;
+        ThreadedEntityIterator<GridView, /*codim=*/0> threadedElemIt(this->gridView_);
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:numSwitched) reduction(min:succeeded)
+#endif
+        {
+            // Attention: the variables below are thread specific and thus cannot be
+            // moved in front of the #pragma!
             ElementContext elemCtx(this->simulator_);
-
-            ElementIterator elemIt = this->gridView_.template begin<0>();
-            ElementIterator elemEndIt = this->gridView_.template end<0>();
-            for (; elemIt != elemEndIt; ++elemIt) {
+            ElementIterator elemIt = threadedElemIt.beginParallel();
+            for (; !threadedElemIt.isFinished(elemIt); elemIt = threadedElemIt.increment()) {
                 const Element& elem = *elemIt;
                 if (elem.partitionType() != Dune::InteriorEntity)
                     continue;
-                elemCtx.updateStencil(elem);
-
-                size_t numLocalDof = elemCtx.stencil(/*timeIdx=*/0).numPrimaryDof();
-                for (unsigned dofIdx = 0; dofIdx < numLocalDof; ++dofIdx) {
-                    unsigned globalIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
-
-                    if (visited[globalIdx])
-                        continue;
-                    visited[globalIdx] = true;
-
-                    // compute the intensive quantities of the current degree of freedom
-                    auto& priVars = this->solution(/*timeIdx=*/0)[globalIdx];
-                    elemCtx.updateIntensiveQuantities(priVars, dofIdx, /*timeIdx=*/0);
-                    const IntensiveQuantities& intQuants = elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/0);
-
-                    // evaluate primary variable switch
-                    short oldPhasePresence = priVars.phasePresence();
-
-                    // set the primary variables and the new phase state
-                    // from the current fluid state
-                    priVars.assignNaive(intQuants.fluidState());
-
-                    if (oldPhasePresence != priVars.phasePresence()) {
-                        if (verbosity_ > 1)
-                            printSwitchedPhases_(elemCtx,
-                                                 dofIdx,
-                                                 intQuants.fluidState(),
-                                                 oldPhasePresence,
-                                                 priVars);
-                        ++numSwitched_;
-                    }
+
+                try {
+                    numSwitched += switchPrimaryVarsOfElement_(elemCtx, elem, visited.get());
+                }
+                catch (...) {
+                    std::cout << "rank " << this->simulator_.gridView().comm().rank()
+                              << " caught an exception during primary variable switching"
+                              << "\n"  << std::flush;
+                    succeeded = 0;
                 }
             }
-
-            succeeded = 1;
-        }
-        catch (...)
-        {
-            std::cout << "rank " << this->simulator_.gridView().comm().rank()
-                      << " caught an exception during primary variable switching"
-                      << "\n"  << std::flush;
-            succeeded = 0;
         }
         succeeded = this->simulator_.gridView().comm().min(succeeded);
 
@@ -527,13 +511,68 @@ public:
         // make sure that if there was a variable switch in an
         // other partition we will also set the switch flag
         // for our partition.
-        numSwitched_ = this->gridView_.comm().sum(numSwitched_);
+        numSwitched_ = this->gridView_.comm().sum(numSwitched);
 
         if (verbosity_ > 0)
             this->simulator_.model().newtonMethod().endIterMsg()
                 << ", num switched=" << numSwitched_;
     }
 
+    // switch the primary variables of all degrees of freedom of an element which have
+    // not yet been visited. returns the number of switched degrees of freedom.
+    unsigned switchPrimaryVarsOfElement_(ElementContext& elemCtx,
+                                         const Element& elem,
+                                         std::atomic<bool>* visited)
+    {
+        unsigned numSwitched = 0;
+        elemCtx.updateStencil(elem);
+
+        size_t numLocalDof = elemCtx.stencil(/*timeIdx=*/0).numPrimaryDof();
+        for (unsigned dofIdx = 0; dofIdx < numLocalDof; ++dofIdx) {
+            unsigned globalIdx = elemCtx.globalSpaceIndex(dofIdx, /*timeIdx=*/0);
+            if (visited[globalIdx].exchange(true, std::memory_order_relaxed))
+                continue;
+
+            // use the cached intensive quantities of the current degree of freedom if
+            // they are available, else compute them
+            auto& priVars = this->solution(/*timeIdx=*/0)[globalIdx];
+            const IntensiveQuantities* intQuants = this->cachedIntensiveQuantities(globalIdx, /*timeIdx=*/0);
+            bool fromCache = (intQuants != nullptr);
+            if (!fromCache) {
+                elemCtx.updateIntensiveQuantities(priVars, dofIdx, /*timeIdx=*/0);
+                intQuants = &elemCtx.intensiveQuantities(dofIdx, /*timeIdx=*/0);
+            }
+
+            // evaluate primary variable switch
+            short oldPhasePresence = priVars.phasePresence();
+            const PrimaryVariables oldPriVars(priVars);
+
+            // set the primary variables and the new phase state
+            // from the current fluid state
+            priVars.assignNaive(intQuants->fluidState());
+
+            if (oldPhasePresence != priVars.phasePresence()) {
+                if (verbosity_ > 1) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                    printSwitchedPhases_(elemCtx,
+                                         dofIdx,
+                                         intQuants->fluidState(),
+                                         oldPhasePresence,
+                                         priVars);
+                }
+                ++numSwitched;
+            }
+            else if (!fromCache && priVars == oldPriVars)
+                // the primary variables were not modified, so the intensive quantities
+                // can be reused by the next linearization
+                this->updateCachedIntensiveQuantities(*intQuants, globalIdx, /*timeIdx=*/0);
+        }
+
+        return numSwitched;
+    }
+
     template <class FluidState>
     void printSwitchedPhases_(const ElementContext& elemCtx,
                               unsigned dofIdx,
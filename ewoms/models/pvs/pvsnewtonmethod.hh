@@ -60,6 +60,15 @@ public:
     PvsNewtonMethod(Simulator& simulator) : ParentType(simulator)
     {}
 
+    /*!
+     * \copydoc NewtonMethod::updateIsThreadSafe
+     *
+     * The update of the PVS primary variables only depends on the values of the
+     * respective degree of freedom.
+     */
+    static bool updateIsThreadSafe()
+    { return true; }
+
 protected:
     friend NewtonMethod<TypeTag>;
     friend ParentType;
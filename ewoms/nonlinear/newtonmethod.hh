@@ -44,7 +44,9 @@
 #include <dune/common/version.hh>
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <exception>
 #include <iostream>
+#include <map>
 #include <sstream>
 
 #include <unistd.h>
@@ -372,6 +374,24 @@ public:
                 asImp_().preSolve_(currentSolution, b);
                 updateTimer_.stop();
 
+                // a localized linearization reuses the contributions of the elements
+                // whose solution did not change significantly, i.e., their residual is
+                // not up to date. convergence must not be concluded from it, so the
+                // whole domain is re-linearized in this case.
+                if (asImp_().converged() && linearizer.linearizationIsLocalized()) {
+                    linearizeTimer_.start();
+                    linearizer.forceFullLinearization();
+                    asImp_().linearizeDomain_();
+                    linearizeTimer_.stop();
+
+                    updateTimer_.start();
+                    Scalar lastError = lastError_;
+                    linearSolver_.prepareRhs(M, b);
+                    asImp_().preSolve_(currentSolution, b);
+                    lastError_ = lastError;
+                    updateTimer_.stop();
+                }
+
                 asImp_().linearizeAuxiliaryEquations_();
 
                 if (!asImp_().proceed_()) {
@@ -570,6 +590,17 @@ public:
     const Ewoms::Timer& updateTimer() const
     { return updateTimer_; }
 
+    /*!
+     * \brief Returns true if the primary variables of different degrees of freedom can
+     *        be updated concurrently.
+     *
+     * If this method returns true, the updatePrimaryVariables_() and
+     * updateConstraintDof_() methods of the Newton method must be thread-safe. Since
+     * this is not the case for many problems, the update is sequential by default.
+     */
+    static bool updateIsThreadSafe()
+    { return false; }
+
 protected:
     /*!
      * \brief Returns true if the Newton method ought to be chatty.
@@ -736,6 +767,9 @@ protected:
      * use the standard Newton-Raphson update strategy, i.e.
      * \f[ u^{k+1} = u^k - \Delta u^k \f]
      *
+     * The degrees of freedom of the grid are updated concurrently if multiple threads
+     * are used.
+     *
      * \param nextSolution The solution vector after the current iteration
      * \param currentSolution The solution vector after the last iteration
      * \param solutionUpdate The delta vector as calculated by solving the linear system
@@ -757,30 +791,40 @@ protected:
         if (!std::isfinite(solutionUpdate.one_norm()))
             throw Opm::NumericalIssue("Non-finite update!");
 
-        size_t numGridDof = model().numGridDof();
-        for (unsigned dofIdx = 0; dofIdx < numGridDof; ++dofIdx) {
-            if (enableConstraints_()) {
-                if (constraintsMap.count(dofIdx) > 0) {
-                    const auto& constraints = constraintsMap.at(dofIdx);
-                    asImp_().updateConstraintDof_(dofIdx,
-                                                  nextSolution[dofIdx],
-                                                  constraints);
-                }
-                else
-                    asImp_().updatePrimaryVariables_(dofIdx,
-                                                     nextSolution[dofIdx],
-                                                     currentSolution[dofIdx],
-                                                     solutionUpdate[dofIdx],
-                                                     currentResidual[dofIdx]);
+        // the primary variables of the grid DOFs are only updated in parallel if the
+        // Newton method states that its updatePrimaryVariables_() and
+        // updateConstraintDof_() methods are thread-safe. since exceptions must not
+        // escape from the threaded loop, the first one is stored and re-thrown after the
+        // loop.
+        int numGridDof = static_cast<int>(model().numGridDof());
+        bool updateInParallel = Implementation::updateIsThreadSafe();
+        int succeeded = 1;
+        std::exception_ptr exc;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(min:succeeded) if(updateInParallel)
+#endif
+        for (int dofIdx = 0; dofIdx < numGridDof; ++dofIdx) {
+            try {
+                updateGridDof_(static_cast<unsigned>(dofIdx),
+                               constraintsMap,
+                               nextSolution,
+                               currentSolution,
+                               solutionUpdate,
+                               currentResidual);
+            }
+            catch (...) {
+                succeeded = 0;
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+                if (!exc)
+                    exc = std::current_exception();
             }
-            else
-                asImp_().updatePrimaryVariables_(dofIdx,
-                                                 nextSolution[dofIdx],
-                                                 currentSolution[dofIdx],
-                                                 solutionUpdate[dofIdx],
-                                                 currentResidual[dofIdx]);
         }
 
+        if (!succeeded)
+            std::rethrow_exception(exc);
+
         // update the DOFs of the auxiliary equations
         size_t numDof = model().numTotalDof();
         for (size_t dofIdx = numGridDof; dofIdx < numDof; ++dofIdx) {
@@ -789,6 +833,38 @@ protected:
         }
     }
 
+    /*!
+     * \brief Update the primary variables of a single degree of freedom of the grid.
+     */
+    void updateGridDof_(unsigned dofIdx,
+                        const std::map<unsigned, Constraints>& constraintsMap,
+                        SolutionVector& nextSolution,
+                        const SolutionVector& currentSolution,
+                        const GlobalEqVector& solutionUpdate,
+                        const GlobalEqVector& currentResidual)
+    {
+        if (enableConstraints_()) {
+            if (constraintsMap.count(dofIdx) > 0) {
+                const auto& constraints = constraintsMap.at(dofIdx);
+                asImp_().updateConstraintDof_(dofIdx,
+                                              nextSolution[dofIdx],
+                                              constraints);
+            }
+            else
+                asImp_().updatePrimaryVariables_(dofIdx,
+                                                 nextSolution[dofIdx],
+                                                 currentSolution[dofIdx],
+                                                 solutionUpdate[dofIdx],
+                                                 currentResidual[dofIdx]);
+        }
+        else
+            asImp_().updatePrimaryVariables_(dofIdx,
+                                             nextSolution[dofIdx],
+                                             currentSolution[dofIdx],
+                                             solutionUpdate[dofIdx],
+                                             currentResidual[dofIdx]);
+    }
+
     /*!
      * \brief Update the primary variables for a degree of freedom which is constraint.
      */
@@ -0,0 +1,209 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Checks the compressed sparse row storage of the transmissibilities of
+ *        EclTransmissibility using a small Cartesian deck.
+ */
+#include "config.h"
+
+#include <ebos/eclproblem.hh>
+#include <ewoms/common/start.hh>
+
+#include <opm/parser/eclipse/Units/Units.hpp>
+
+#if HAVE_DUNE_FEM
+#include <dune/fem/misc/mpimanager.hh>
+#else
+#include <dune/common/parallel/mpihelper.hh>
+#endif
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#define CHECK(value, expected)             \
+    {                                      \
+        if ((value) != (expected))         \
+            std::abort();                  \
+    }
+
+#define CHECK_CLOSE(value, expected, reltol)                            \
+    {                                                                   \
+        if (std::fabs((expected) - (value)) > 1e-14 &&                  \
+            std::fabs(((expected) - (value))/((expected) + (value))) > reltol) \
+            { \
+            std::cout << "Test failure: "; \
+            std::cout << "expected value " << expected << " is not close to value " << value << std::endl; \
+            std::abort();                                               \
+            } \
+    } \
+
+#define REQUIRE(cond)                      \
+    {                                      \
+        if (!(cond))                       \
+            std::abort();                  \
+    }
+
+BEGIN_PROPERTIES
+
+NEW_TYPE_TAG(TestEclTransmissibilityTypeTag, INHERITS_FROM(BlackOilModel, EclBaseProblem));
+SET_BOOL_PROP(TestEclTransmissibilityTypeTag, EnableAsyncEclOutput, false);
+
+END_PROPERTIES
+
+template <class TypeTag>
+std::unique_ptr<typename GET_PROP_TYPE(TypeTag, Simulator)>
+initSimulator(const char *filename)
+{
+    typedef typename GET_PROP_TYPE(TypeTag, Simulator) Simulator;
+
+    std::string filenameArg = "--ecl-deck-file-name=";
+    filenameArg += filename;
+
+    const char* argv[] = {
+        "test_ecltransmissibility",
+        filenameArg.c_str()
+    };
+
+    Ewoms::setupParameters_<TypeTag>(/*argc=*/sizeof(argv)/sizeof(argv[0]), argv, /*registerParams=*/false);
+
+    return std::unique_ptr<Simulator>(new Simulator);
+}
+
+void test_transmissibilities();
+void test_transmissibilities()
+{
+    typedef typename TTAG(TestEclTransmissibilityTypeTag) TypeTag;
+    typedef typename GET_PROP_TYPE(TypeTag, Scalar) Scalar;
+
+    // the deck consists of 2x2x3 cells of 10m x 10m x 1m with a horizontal
+    // permeability of 100 mD and a vertical one of 10 mD
+    auto simulator = initSimulator<TypeTag>("data/ebos_blackoil.DATA");
+    const auto& vanguard = simulator->vanguard();
+    const auto& trans = simulator->problem().eclTransmissibilities();
+
+    const unsigned nx = 2;
+    const unsigned ny = 2;
+    const unsigned numElements = vanguard.gridView().size(/*codim=*/0);
+    REQUIRE(numElements == 12);
+
+    const auto& offsets = trans.neighborOffsets();
+    const auto& indices = trans.neighborIndices();
+    REQUIRE(offsets.size() == numElements + 1);
+    CHECK(offsets[0], 0u);
+    CHECK(offsets[numElements], static_cast<unsigned>(indices.size()));
+
+    // every cell has one neighbor in each direction, i.e., there are 2*ny*nz faces in
+    // x-direction, 2*nx*nz ones in y-direction and 4*nx*ny ones in z-direction. each
+    // face is stored for both of its cells.
+    CHECK(indices.size(), 40u);
+
+    const Scalar horizontalTrans = Opm::unit::convert::from(100.0, Opm::prefix::milli*Opm::unit::darcy);
+    const Scalar verticalTrans = Opm::unit::convert::from(1000.0, Opm::prefix::milli*Opm::unit::darcy);
+
+    for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+        const unsigned cartElemIdx = vanguard.cartesianIndex(elemIdx);
+        for (unsigned i = offsets[elemIdx]; i < offsets[elemIdx + 1]; ++i) {
+            const unsigned neighborIdx = indices[i];
+
+            // the rows must be sorted and must not contain any duplicates
+            if (i > offsets[elemIdx])
+                REQUIRE(indices[i - 1] < neighborIdx);
+            REQUIRE(neighborIdx != elemIdx);
+
+            CHECK(trans.faceIndex(elemIdx, neighborIdx), i);
+            CHECK(indices[trans.faceIndex(neighborIdx, elemIdx)], elemIdx);
+            CHECK(trans.transmissibility(elemIdx, neighborIdx),
+                  trans.transmissibility(neighborIdx, elemIdx));
+
+            const unsigned cartNeighborIdx = vanguard.cartesianIndex(neighborIdx);
+            const unsigned cartDist =
+                (cartElemIdx > cartNeighborIdx)
+                ? cartElemIdx - cartNeighborIdx
+                : cartNeighborIdx - cartElemIdx;
+            if (cartDist == 1 || cartDist == nx) {
+                CHECK_CLOSE(trans.transmissibility(elemIdx, neighborIdx), horizontalTrans, 1e-8);
+            }
+            else {
+                CHECK(cartDist, nx*ny);
+                CHECK_CLOSE(trans.transmissibility(elemIdx, neighborIdx), verticalTrans, 1e-8);
+            }
+        }
+    }
+
+    // the lookup must fail for pairs of cells which do not share a face
+    for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+        bool caught = false;
+        try {
+            trans.faceIndex(elemIdx, elemIdx);
+        }
+        catch (const std::out_of_range&) {
+            caught = true;
+        }
+        REQUIRE(caught);
+    }
+
+    unsigned diagonalElemIdx = numElements;
+    for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+        // the cells at the opposite corners of a layer do not share a face
+        if (vanguard.cartesianIndex(elemIdx) == nx*ny - 1)
+            diagonalElemIdx = elemIdx;
+    }
+    REQUIRE(diagonalElemIdx < numElements);
+
+    unsigned firstElemIdx = numElements;
+    for (unsigned elemIdx = 0; elemIdx < numElements; ++elemIdx) {
+        if (vanguard.cartesianIndex(elemIdx) == 0)
+            firstElemIdx = elemIdx;
+    }
+    REQUIRE(firstElemIdx < numElements);
+
+    bool caught = false;
+    try {
+        trans.transmissibility(firstElemIdx, diagonalElemIdx);
+    }
+    catch (const std::out_of_range&) {
+        caught = true;
+    }
+    REQUIRE(caught);
+}
+
+int main(int argc, char** argv)
+{
+#if HAVE_DUNE_FEM
+    Dune::Fem::MPIManager::initialize(argc, argv);
+#else
+    Dune::MPIHelper::instance(argc, argv);
+#endif
+
+    typedef TTAG(TestEclTransmissibilityTypeTag) TypeTag;
+    Ewoms::registerAllParameters_<TypeTag>();
+    test_transmissibilities();
+
+    return 0;
+}
@@ -37,12 +37,15 @@
 #include <dune/common/parallel/mpihelper.hh>
 #endif
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <iostream>
 #include <limits>
 #include <memory>
 #include <numeric>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <string.h>
@@ -214,6 +217,66 @@ static Opm::EquilRecord mkEquilRecord( double datd, double datp,
     return EquilRecord( rec );
 }
 
+void test_AdaptiveRKIVP();
+void test_AdaptiveRKIVP()
+{
+    const double reltol = 1.0e-7;
+
+    // exponential growth, integrated in both directions
+    {
+        const auto rhs = [](const double /* x */, const double y) { return y; };
+        typedef Ewoms::EQUIL::Details::AdaptiveRKIVP<decltype(rhs)> Integrator;
+
+        const Integrator forward(rhs, {{ 0.0, 1.0 }}, 1.0);
+        const Integrator backward(rhs, {{ 1.0, 0.0 }}, std::exp(1.0));
+        for (int i = 0; i <= 20; ++i) {
+            const double x = i/20.0 + 0.013*(i % 3);
+            CHECK_CLOSE(forward(x), std::exp(x), reltol);
+            CHECK_CLOSE(backward(x), std::exp(x), reltol);
+        }
+    }
+
+    // hydrostatic pressure of a slightly compressible fluid, i.e., dp/dz = rho(p)*g
+    // with rho(p) = rho0*exp(c*(p - p0)). the analytic solution of this is
+    // p(z) = p0 - ln(1 - c*g*rho0*(z - z0))/c.
+    {
+        const double rho0 = 800;
+        const double c = 1e-9;
+        const double g = 9.80665;
+        const double z0 = 1000;
+        const double p0 = 1e7;
+        const auto rhs = [=](const double /* z */, const double p)
+            { return rho0*std::exp(c*(p - p0))*g; };
+        const auto exact = [=](const double z)
+            { return p0 - std::log(1 - c*g*rho0*(z - z0))/c; };
+        typedef Ewoms::EQUIL::Details::AdaptiveRKIVP<decltype(rhs)> Integrator;
+
+        const Integrator down(rhs, {{ z0, z0 + 150 }}, p0);
+        const Integrator up(rhs, {{ z0, z0 - 150 }}, p0);
+        for (int i = 0; i <= 30; ++i) {
+            const double dz = 5.0*i + 0.37;
+            CHECK_CLOSE(down(z0 + std::min(dz, 150.0)), exact(z0 + std::min(dz, 150.0)), reltol);
+            CHECK_CLOSE(up(z0 - std::min(dz, 150.0)), exact(z0 - std::min(dz, 150.0)), reltol);
+        }
+    }
+
+    // a right hand side which cannot be evaluated must result in an exception
+    {
+        const auto rhs = [](const double x, const double /* y */)
+            { return (x > 0.5) ? std::numeric_limits<double>::quiet_NaN() : 1.0; };
+        typedef Ewoms::EQUIL::Details::AdaptiveRKIVP<decltype(rhs)> Integrator;
+
+        bool caught = false;
+        try {
+            const Integrator integrator(rhs, {{ 0.0, 1.0 }}, 0.0);
+        }
+        catch (const std::runtime_error&) {
+            caught = true;
+        }
+        REQUIRE(caught);
+    }
+}
+
 void test_PhasePressure();
 void test_PhasePressure()
 {
@@ -1110,6 +1173,7 @@ int main(int argc, char** argv)
     typedef TTAG(TestEquilTypeTag) TypeTag;
     Ewoms::registerAllParameters_<TypeTag>();
 
+    test_AdaptiveRKIVP();
     test_PhasePressure();
     test_CellSubset();
     test_RegMapping();
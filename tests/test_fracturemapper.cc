@@ -0,0 +1,130 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Checks the queries of the fracture topology which is stored by
+ *        Ewoms::FractureMapper.
+ */
+#include "config.h"
+
+#include <ewoms/models/discretefracture/fracturemapper.hh>
+
+#include <iostream>
+#include <stdexcept>
+
+BEGIN_PROPERTIES
+
+NEW_TYPE_TAG(FractureMapperTestTypeTag);
+
+END_PROPERTIES
+
+int main()
+{
+    typedef Ewoms::FractureMapper<TTAG(FractureMapperTestTypeTag)> FractureMapper;
+
+    FractureMapper mapper;
+
+    // a mapper without any fractures does not need to be finalized
+    if (mapper.isFractureVertex(0) || mapper.isFractureEdge(0, 1)) {
+        std::cout << "An empty fracture mapper reports a fracture\n";
+        return 1;
+    }
+
+    // a fracture along the vertices 2 - 5 - 7 plus a separate one between 10 and 3.
+    // the second edge is specified twice, once in the opposite direction.
+    mapper.addFractureEdge(2, 5);
+    mapper.addFractureEdge(5, 7);
+    mapper.addFractureEdge(7, 5);
+    mapper.addFractureEdge(10, 3);
+
+    // querying the topology before it is finalized must fail
+    bool caught = false;
+    try {
+        mapper.isFractureEdge(2, 5);
+    }
+    catch (const std::logic_error&) {
+        caught = true;
+    }
+    if (!caught) {
+        std::cout << "Querying a fracture mapper which is not finalized did not fail\n";
+        return 1;
+    }
+
+    mapper.finalize();
+
+    const unsigned fractureVertices[] = { 2, 3, 5, 7, 10 };
+    for (unsigned vertexIdx = 0; vertexIdx < 12; ++vertexIdx) {
+        bool expected = false;
+        for (unsigned fracVertexIdx : fractureVertices)
+            expected = expected || (vertexIdx == fracVertexIdx);
+
+        if (mapper.isFractureVertex(vertexIdx) != expected) {
+            std::cout << "Vertex " << vertexIdx << " is wrongly classified\n";
+            return 1;
+        }
+    }
+
+    const unsigned fractureEdges[][2] = { {2, 5}, {5, 7}, {3, 10} };
+    for (unsigned vertex1Idx = 0; vertex1Idx < 12; ++vertex1Idx) {
+        for (unsigned vertex2Idx = 0; vertex2Idx < 12; ++vertex2Idx) {
+            bool expected = false;
+            for (const auto& edge : fractureEdges)
+                expected = expected
+                    || (edge[0] == vertex1Idx && edge[1] == vertex2Idx)
+                    || (edge[1] == vertex1Idx && edge[0] == vertex2Idx);
+
+            if (mapper.isFractureEdge(vertex1Idx, vertex2Idx) != expected) {
+                std::cout << "Edge (" << vertex1Idx << ", " << vertex2Idx
+                          << ") is wrongly classified\n";
+                return 1;
+            }
+        }
+    }
+
+    // edges can be added to a finalized mapper, but then it needs to be finalized again
+    mapper.addFractureEdge(7, 11);
+    caught = false;
+    try {
+        mapper.isFractureVertex(11);
+    }
+    catch (const std::logic_error&) {
+        caught = true;
+    }
+    if (!caught) {
+        std::cout << "Adding an edge did not require the mapper to be finalized again\n";
+        return 1;
+    }
+
+    mapper.finalize();
+    if (!mapper.isFractureEdge(11, 7)
+        || !mapper.isFractureEdge(7, 5)
+        || !mapper.isFractureEdge(10, 3)
+        || mapper.isFractureEdge(11, 5))
+    {
+        std::cout << "Re-finalizing the fracture mapper lost or invented edges\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Checks the validity tracking of the intensive quantity cache of
+ *        FvBaseDiscretization using the lens problem.
+ */
+#include "config.h"
+
+#include "lens_immiscible_ecfv_ad.hh"
+
+#include <ewoms/common/start.hh>
+
+#if HAVE_DUNE_FEM
+#include <dune/fem/misc/mpimanager.hh>
+#else
+#include <dune/common/parallel/mpihelper.hh>
+#endif
+
+#include <cstdlib>
+#include <iostream>
+
+template <class Model>
+static bool allCached_(const Model& model, unsigned timeIdx)
+{
+    for (unsigned dofIdx = 0; dofIdx < model.numGridDof(); ++dofIdx)
+        if (!model.cachedIntensiveQuantities(dofIdx, timeIdx))
+            return false;
+    return true;
+}
+
+template <class Model>
+static bool noneCached_(const Model& model, unsigned timeIdx)
+{
+    for (unsigned dofIdx = 0; dofIdx < model.numGridDof(); ++dofIdx)
+        if (model.cachedIntensiveQuantities(dofIdx, timeIdx))
+            return false;
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+#if HAVE_DUNE_FEM
+    Dune::Fem::MPIManager::initialize(argc, argv);
+#else
+    Dune::MPIHelper::instance(argc, argv);
+#endif
+
+    typedef TTAG(LensProblemEcfvAd) TypeTag;
+    typedef typename GET_PROP_TYPE(TypeTag, Simulator) Simulator;
+    typedef typename GET_PROP_TYPE(TypeTag, ThreadManager) ThreadManager;
+
+    const char* testArgv[] = {
+        "test_intensivequantitycache",
+        "--end-time=3000",
+        "--initial-time-step-size=250",
+        "--enable-intensive-quantity-cache=true",
+        "--enable-storage-cache=false"
+    };
+    int paramStatus =
+        Ewoms::setupParameters_<TypeTag>(/*argc=*/sizeof(testArgv)/sizeof(testArgv[0]), testArgv);
+    if (paramStatus != 0)
+        return 1;
+
+    ThreadManager::init();
+
+    Simulator simulator(/*verbose=*/false);
+    auto& model = simulator.model();
+    auto& linearizer = model.linearizer();
+    model.applyInitialSolution();
+
+    if (!noneCached_(model, /*timeIdx=*/0) || !noneCached_(model, /*timeIdx=*/1)) {
+        std::cout << "The cache must be empty before the first linearization\n";
+        return 1;
+    }
+
+    // linearizing the whole domain computes the intensive quantities of all degrees
+    // of freedom for both time levels
+    linearizer.linearizeDomain();
+    if (!allCached_(model, /*timeIdx=*/0) || !allCached_(model, /*timeIdx=*/1)) {
+        std::cout << "The linearization did not populate the cache\n";
+        return 1;
+    }
+
+    // invalidating a single entry must not affect any other one
+    model.setIntensiveQuantitiesCacheEntryValidity(/*dofIdx=*/0, /*timeIdx=*/0, false);
+    if (model.cachedIntensiveQuantities(/*dofIdx=*/0, /*timeIdx=*/0)
+        || !model.cachedIntensiveQuantities(/*dofIdx=*/1, /*timeIdx=*/0)
+        || !model.cachedIntensiveQuantities(/*dofIdx=*/0, /*timeIdx=*/1))
+    {
+        std::cout << "Invalidating a single cache entry did not work\n";
+        return 1;
+    }
+
+    // invalidating a time level must not affect the other one
+    model.invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
+    if (!noneCached_(model, /*timeIdx=*/0) || !allCached_(model, /*timeIdx=*/1)) {
+        std::cout << "Invalidating the most recent time level did not work\n";
+        return 1;
+    }
+
+    // entries which were valid in some earlier epoch must stay invalid, and an
+    // update only validates the entry which is updated
+    for (unsigned i = 0; i < 100; ++i)
+        model.invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
+    const auto* oldIntQuants = model.cachedIntensiveQuantities(/*dofIdx=*/0, /*timeIdx=*/1);
+    model.updateCachedIntensiveQuantities(*oldIntQuants, /*dofIdx=*/0, /*timeIdx=*/0);
+    if (!model.cachedIntensiveQuantities(/*dofIdx=*/0, /*timeIdx=*/0)) {
+        std::cout << "Updating a cache entry did not make it valid\n";
+        return 1;
+    }
+    for (unsigned dofIdx = 1; dofIdx < model.numGridDof(); ++dofIdx) {
+        if (model.cachedIntensiveQuantities(dofIdx, /*timeIdx=*/0)) {
+            std::cout << "Cache entry " << dofIdx << " became valid without being updated\n";
+            return 1;
+        }
+    }
+
+    // after advancing the time level, the intensive quantities of the most recent
+    // time level are the ones of the previous one until the solution is modified
+    linearizer.linearizeDomain();
+    model.advanceTimeLevel();
+    for (unsigned dofIdx = 0; dofIdx < model.numGridDof(); ++dofIdx) {
+        const auto* intQuants = model.cachedIntensiveQuantities(dofIdx, /*timeIdx=*/0);
+        if (!intQuants || intQuants != model.cachedIntensiveQuantities(dofIdx, /*timeIdx=*/1)) {
+            std::cout << "Cache entry " << dofIdx << " does not mirror the previous time level\n";
+            return 1;
+        }
+    }
+
+    model.setIntensiveQuantitiesCacheEntryValidity(/*dofIdx=*/0, /*timeIdx=*/0, false);
+    if (model.cachedIntensiveQuantities(/*dofIdx=*/0, /*timeIdx=*/0)
+        || !model.cachedIntensiveQuantities(/*dofIdx=*/0, /*timeIdx=*/1)
+        || !model.cachedIntensiveQuantities(/*dofIdx=*/1, /*timeIdx=*/0))
+    {
+        std::cout << "Invalidating a mirrored cache entry did not work\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,152 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Compares the localized linearization of FvBaseLinearizer with a full
+ *        linearization using the lens problem.
+ */
+#include "config.h"
+
+#include "lens_immiscible_ecfv_ad.hh"
+
+#include <ewoms/common/start.hh>
+
+#if HAVE_DUNE_FEM
+#include <dune/fem/misc/mpimanager.hh>
+#else
+#include <dune/common/parallel/mpihelper.hh>
+#endif
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+template <class Scalar>
+static bool isClose_(Scalar a, Scalar b)
+{ return std::abs(a - b) <= 1e-10*(std::abs(a) + std::abs(b)) + 1e-30; }
+
+int main(int argc, char **argv)
+{
+#if HAVE_DUNE_FEM
+    Dune::Fem::MPIManager::initialize(argc, argv);
+#else
+    Dune::MPIHelper::instance(argc, argv);
+#endif
+
+    typedef TTAG(LensProblemEcfvAd) TypeTag;
+    typedef typename GET_PROP_TYPE(TypeTag, Simulator) Simulator;
+    typedef typename GET_PROP_TYPE(TypeTag, Scalar) Scalar;
+    typedef typename GET_PROP_TYPE(TypeTag, ThreadManager) ThreadManager;
+    typedef typename GET_PROP_TYPE(TypeTag, GlobalEqVector) GlobalEqVector;
+    typedef typename GET_PROP_TYPE(TypeTag, JacobianMatrix) Matrix;
+
+    const char* testArgv[] = {
+        "test_localizedlinearization",
+        "--end-time=3000",
+        "--initial-time-step-size=250",
+        "--enable-localized-linearization=true",
+        "--localized-linearization-tolerance=1e-10",
+        "--localized-linearization-max-active-fraction=0.9"
+    };
+    int paramStatus =
+        Ewoms::setupParameters_<TypeTag>(/*argc=*/sizeof(testArgv)/sizeof(testArgv[0]), testArgv);
+    if (paramStatus != 0)
+        return 1;
+
+    ThreadManager::init();
+
+    Simulator simulator(/*verbose=*/false);
+    auto& model = simulator.model();
+    auto& linearizer = model.linearizer();
+    model.applyInitialSolution();
+
+    // the first iteration of a time step always linearizes all elements
+    model.newtonMethod().setIterationIndex(0);
+    linearizer.linearizeDomain();
+    if (linearizer.linearizationIsLocalized()) {
+        std::cout << "The first iteration of a time step must not be localized\n";
+        return 1;
+    }
+
+    // change the pressure of a few degrees of freedom. only the elements in their
+    // neighborhood need to be re-linearized.
+    auto& sol = model.solution(/*timeIdx=*/0);
+    for (unsigned dofIdx = 0; dofIdx < sol.size(); dofIdx += 20)
+        sol[dofIdx][/*pvIdx=*/0] += 1e3;
+    model.invalidateIntensiveQuantitiesCache(/*timeIdx=*/0);
+
+    model.newtonMethod().setIterationIndex(1);
+    linearizer.linearizeDomain();
+    if (!linearizer.linearizationIsLocalized()) {
+        std::cout << "The second iteration of a time step was expected to be localized\n";
+        return 1;
+    }
+
+    GlobalEqVector localizedResidual(linearizer.residual());
+    Matrix localizedMatrix(linearizer.matrix());
+
+    // the full linearization for the same solution must yield the same system
+    linearizer.forceFullLinearization();
+    linearizer.linearizeDomain();
+    if (linearizer.linearizationIsLocalized()) {
+        std::cout << "Forcing a full linearization did not have any effect\n";
+        return 1;
+    }
+
+    const auto& fullResidual = linearizer.residual();
+    const auto& fullMatrix = linearizer.matrix();
+    for (unsigned dofIdx = 0; dofIdx < fullResidual.size(); ++dofIdx) {
+        for (unsigned eqIdx = 0; eqIdx < fullResidual[dofIdx].size(); ++eqIdx) {
+            if (!isClose_<Scalar>(localizedResidual[dofIdx][eqIdx], fullResidual[dofIdx][eqIdx])) {
+                std::cout << "Residual of degree of freedom " << dofIdx << " differs: "
+                          << localizedResidual[dofIdx][eqIdx] << " (localized) vs. "
+                          << fullResidual[dofIdx][eqIdx] << " (full)\n";
+                return 1;
+            }
+        }
+    }
+
+    auto rowIt = fullMatrix.begin();
+    const auto& rowEndIt = fullMatrix.end();
+    for (; rowIt != rowEndIt; ++rowIt) {
+        auto colIt = rowIt->begin();
+        const auto& colEndIt = rowIt->end();
+        for (; colIt != colEndIt; ++colIt) {
+            const auto& fullBlock = *colIt;
+            const auto& localizedBlock = localizedMatrix[rowIt.index()][colIt.index()];
+            for (unsigned i = 0; i < fullBlock.N(); ++i) {
+                for (unsigned j = 0; j < fullBlock.M(); ++j) {
+                    if (!isClose_<Scalar>(localizedBlock[i][j], fullBlock[i][j])) {
+                        std::cout << "Jacobian entry (" << rowIt.index() << ", " << colIt.index()
+                                  << ") differs: " << localizedBlock[i][j] << " (localized) vs. "
+                                  << fullBlock[i][j] << " (full)\n";
+                        return 1;
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
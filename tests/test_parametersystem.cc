@@ -0,0 +1,135 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Makes sure that the cached values of the run-time parameters follow the
+ *        modifications of the parameter tree.
+ */
+#include "config.h"
+
+#include <ewoms/common/parametersystem.hh>
+
+#include <iostream>
+#include <stdexcept>
+
+BEGIN_PROPERTIES
+
+NEW_TYPE_TAG(ParameterTestTypeTag, INHERITS_FROM(ParameterSystem));
+
+NEW_PROP_TAG(Scalar);
+NEW_PROP_TAG(NumIterations);
+NEW_PROP_TAG(Tolerance);
+
+SET_TYPE_PROP(ParameterTestTypeTag, Scalar, double);
+SET_INT_PROP(ParameterTestTypeTag, NumIterations, 3);
+SET_SCALAR_PROP(ParameterTestTypeTag, Tolerance, 1e-5);
+
+END_PROPERTIES
+
+typedef TTAG(ParameterTestTypeTag) TypeTag;
+typedef GET_PROP(TypeTag, ParameterMetaData) ParamsMeta;
+
+static void registerParameters_()
+{
+    EWOMS_REGISTER_PARAM(TypeTag, int, NumIterations, "The number of iterations");
+    EWOMS_REGISTER_PARAM(TypeTag, double, Tolerance, "The tolerance");
+}
+
+int main()
+{
+    registerParameters_();
+
+    // parameters can only be retrieved after all of them have been registered
+    bool caught = false;
+    try {
+        EWOMS_GET_PARAM(TypeTag, int, NumIterations);
+    }
+    catch (const std::runtime_error&) {
+        caught = true;
+    }
+    if (!caught) {
+        std::cout << "A parameter could be retrieved while the registration was open\n";
+        return 1;
+    }
+
+    EWOMS_END_PARAM_REGISTRATION(TypeTag);
+    if (EWOMS_GET_PARAM(TypeTag, int, NumIterations) != 3
+        || EWOMS_GET_PARAM(TypeTag, double, Tolerance) != 1e-5)
+    {
+        std::cout << "The parameters do not exhibit their default values\n";
+        return 1;
+    }
+
+    // modifying the parameter tree must invalidate the cached values
+    ParamsMeta::tree()["NumIterations"] = "5";
+    if (EWOMS_GET_PARAM(TypeTag, int, NumIterations) != 5) {
+        std::cout << "A stale value of a parameter was returned\n";
+        return 1;
+    }
+
+    Ewoms::Parameters::resolveValues<TypeTag>();
+    if (EWOMS_GET_PARAM(TypeTag, int, NumIterations) != 5
+        || EWOMS_GET_PARAM(TypeTag, double, Tolerance) != 1e-5)
+    {
+        std::cout << "Resolving the parameters changed their values\n";
+        return 1;
+    }
+
+    // registering a parameter after the registration has been closed must fail
+    caught = false;
+    try {
+        registerParameters_();
+    }
+    catch (const std::logic_error&) {
+        caught = true;
+    }
+    if (!caught) {
+        std::cout << "A parameter could be registered after the registration was closed\n";
+        return 1;
+    }
+
+    // after a reset, the parameters need to be registered again and their values are
+    // forgotten
+    Ewoms::Parameters::reset<TypeTag>();
+    caught = false;
+    try {
+        EWOMS_GET_PARAM(TypeTag, int, NumIterations);
+    }
+    catch (const std::runtime_error&) {
+        caught = true;
+    }
+    if (!caught) {
+        std::cout << "A parameter could be retrieved after the parameters were reset\n";
+        return 1;
+    }
+
+    registerParameters_();
+    EWOMS_END_PARAM_REGISTRATION(TypeTag);
+    if (EWOMS_GET_PARAM(TypeTag, int, NumIterations) != 3) {
+        std::cout << "The value of a parameter survived resetting the parameters\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+// -*- mode: C++; tab-width: 4; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+// vi: set et ts=4 sw=4 sts=4:
+/*
+  This file is part of the Open Porous Media project (OPM).
+
+  OPM is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  OPM is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with OPM.  If not, see <http://www.gnu.org/licenses/>.
+
+  Consult the COPYING file in the top-level source directory of this
+  module for the precise wording of the license and the list of
+  copyright holders.
+*/
+/*!
+ * \file
+ *
+ * \brief Makes sure that advancing the time level of FvBaseDiscretization shifts the
+ *        solutions and the cached storage terms by one position without copying them.
+ */
+#include "config.h"
+
+#include "lens_immiscible_ecfv_ad.hh"
+
+#include <ewoms/common/start.hh>
+
+#if HAVE_DUNE_FEM
+#include <dune/fem/misc/mpimanager.hh>
+#else
+#include <dune/common/parallel/mpihelper.hh>
+#endif
+
+#include <cstdlib>
+#include <iostream>
+
+int main(int argc, char **argv)
+{
+#if HAVE_DUNE_FEM
+    Dune::Fem::MPIManager::initialize(argc, argv);
+#else
+    Dune::MPIHelper::instance(argc, argv);
+#endif
+
+    typedef TTAG(LensProblemEcfvAd) TypeTag;
+    typedef typename GET_PROP_TYPE(TypeTag, Simulator) Simulator;
+    typedef typename GET_PROP_TYPE(TypeTag, ThreadManager) ThreadManager;
+    typedef typename GET_PROP_TYPE(TypeTag, SolutionVector) SolutionVector;
+    typedef typename GET_PROP_TYPE(TypeTag, EqVector) EqVector;
+
+    const char* testArgv[] = {
+        "test_timelevels",
+        "--end-time=3000",
+        "--initial-time-step-size=250",
+        "--enable-storage-cache=true"
+    };
+    int paramStatus =
+        Ewoms::setupParameters_<TypeTag>(/*argc=*/sizeof(testArgv)/sizeof(testArgv[0]), testArgv);
+    if (paramStatus != 0)
+        return 1;
+
+    ThreadManager::init();
+
+    Simulator simulator(/*verbose=*/false);
+    auto& model = simulator.model();
+    model.applyInitialSolution();
+
+    // make the solutions of the two time levels distinguishable
+    auto& sol = model.solution(/*timeIdx=*/0);
+    for (unsigned dofIdx = 0; dofIdx < sol.size(); ++dofIdx)
+        sol[dofIdx][/*pvIdx=*/0] += 1e3 + dofIdx;
+    SolutionVector oldSolution(sol);
+
+    for (unsigned dofIdx = 0; dofIdx < sol.size(); ++dofIdx) {
+        EqVector storage(0.0);
+        storage[/*eqIdx=*/0] = dofIdx;
+        model.updateCachedStorage(dofIdx, /*timeIdx=*/0, storage);
+
+        storage[/*eqIdx=*/0] = -1.0;
+        model.updateCachedStorage(dofIdx, /*timeIdx=*/1, storage);
+    }
+
+    const SolutionVector* mostRecentSolution = &model.solution(/*timeIdx=*/0);
+    const EqVector* mostRecentStorage = &model.cachedStorage(/*dofIdx=*/0, /*timeIdx=*/0);
+
+    model.advanceTimeLevel();
+
+    // the most recent time level must have become the previous one without being
+    // copied
+    if (&model.solution(/*timeIdx=*/1) != mostRecentSolution) {
+        std::cout << "The solution of the previous time level was copied\n";
+        return 1;
+    }
+    if (&model.cachedStorage(/*dofIdx=*/0, /*timeIdx=*/1) != mostRecentStorage) {
+        std::cout << "The storage cache of the previous time level was copied\n";
+        return 1;
+    }
+
+    for (unsigned dofIdx = 0; dofIdx < sol.size(); ++dofIdx) {
+        for (unsigned timeIdx = 0; timeIdx < 2; ++timeIdx) {
+            const auto& priVars = model.solution(timeIdx)[dofIdx];
+            for (unsigned pvIdx = 0; pvIdx < priVars.size(); ++pvIdx) {
+                if (priVars[pvIdx] != oldSolution[dofIdx][pvIdx]) {
+                    std::cout << "Primary variable " << pvIdx << " of degree of freedom "
+                              << dofIdx << " for time index " << timeIdx << " is "
+                              << priVars[pvIdx] << " instead of "
+                              << oldSolution[dofIdx][pvIdx] << "\n";
+                    return 1;
+                }
+            }
+        }
+
+        if (model.cachedStorage(dofIdx, /*timeIdx=*/1)[/*eqIdx=*/0] != dofIdx) {
+            std::cout << "The storage term of degree of freedom " << dofIdx
+                      << " was not shifted to the previous time level\n";
+            return 1;
+        }
+    }
+
+    // modifying the most recent solution must not affect the previous one
+    model.solution(/*timeIdx=*/0)[/*dofIdx=*/0][/*pvIdx=*/0] += 1e3;
+    if (model.solution(/*timeIdx=*/1)[/*dofIdx=*/0][/*pvIdx=*/0] != oldSolution[0][0]) {
+        std::cout << "The solutions of the time levels are aliased\n";
+        return 1;
+    }
+
+    return 0;
+}